@@ -0,0 +1,139 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <cmath>
+#include <vector>
+#include <omnetpp.h>
+using namespace omnetpp;
+
+/**
+ * Builds the satellites of a WalkerLEO network and their ISLs, see
+ * WalkerLEO.ned.
+ *
+ * The nodes are created in doBuildInside(), after the submodules of the
+ * NED declaration and before anything is initialized, so to the rest of
+ * the simulation they look like NED submodules. The build is batched:
+ * all the nodes are created and sized for their four ports first, then
+ * built, then wired, so no gate vector is ever resized.
+ */
+class WalkerNetwork : public cModule
+{
+  private:
+    int numPlanes;
+    int numSatPerPlane;
+    std::vector<cModule *> nodes; // indexed by plane * numSatPerPlane + slot, both from 0
+    std::vector<int> usedPorts;
+
+  protected:
+    virtual void doBuildInside() override;
+
+    virtual void createNodes();
+    virtual void connect(int a, int b, const char *linkStyle);
+    virtual void connectGates(cGate *src, cGate *dest, const char *linkStyle);
+    int nodeAt(int plane, int slot) const;
+};
+
+Define_Module(WalkerNetwork);
+
+static const int NUM_PORTS = 4;
+// slot offset of the satellite linked in the next plane, that of NetLEO
+static const int INTER_PLANE_OFFSET = -2;
+
+
+void WalkerNetwork::doBuildInside()
+{
+    // the NED submodules (scenario, membership, ...) first
+    cModule::doBuildInside();
+
+    numPlanes = par("num_of_planes");
+    numSatPerPlane = par("num_of_sat_per_plane");
+    if (numPlanes < 3 || numSatPerPlane < 3)
+        throw cRuntimeError("WalkerLEO needs at least 3 planes of 3 satellites, got %d x %d", numPlanes, numSatPerPlane);
+    this->createNodes();
+
+    // the ring of every plane, and the links to the next plane; the last plane
+    // is linked back to the first one with the same offset
+    for (int plane = 0; plane < numPlanes; plane++)
+    {
+        for (int slot = 0; slot < numSatPerPlane; slot++)
+        {
+            int node = this->nodeAt(plane, slot);
+            if (slot != numSatPerPlane - 1)
+                this->connect(node, this->nodeAt(plane, slot + 1), "ls=,1");
+            else
+                this->connect(node, this->nodeAt(plane, 0), "ls=#729FCF,3,da");
+
+            this->connect(node, this->nodeAt((plane + 1) % numPlanes, slot + INTER_PLANE_OFFSET), "ls=,1");
+        }
+    }
+}
+
+void WalkerNetwork::createNodes()
+{
+    int numNodes = numPlanes * numSatPerPlane;
+    int addressBase = par("addressBase");
+    int intraPlaneBias = par("intra_plane_bias");
+    int interPlaneBias = par("inter_plane_bias");
+    double distance = par("distance_between_sats");
+    double maxY = par("maxY");
+    double phase = tan(par("phase_deg").intValue() * 3.1415 / 180);
+
+    cModuleType *nodeType = cModuleType::get("node.Node");
+    nodes.resize(numNodes);
+    usedPorts.assign(numNodes, 0);
+    for (int index = 0; index < numNodes; index++)
+    {
+        // the address and position formulas of NetLEO
+        int plane = index / numSatPerPlane;
+        int slot = index % numSatPerPlane;
+        cModule *node = nodeType->create("rte", this, numNodes, index);
+        node->par("address").setIntValue((interPlaneBias + plane) * addressBase + (slot + intraPlaneBias) % numSatPerPlane + 1);
+        node->par("posX").setDoubleValue(distance / 2 + slot * distance + plane * distance * 3);
+        node->par("posY").setDoubleValue(maxY - distance / 2 - slot * phase * distance);
+        node->finalizeParameters();
+        node->setGateSize("port", NUM_PORTS);
+        nodes[index] = node;
+    }
+    for (cModule *node : nodes)
+    {
+        node->buildInside();
+    }
+}
+
+int WalkerNetwork::nodeAt(int plane, int slot) const
+{
+    // slots wrap around the plane
+    slot = ((slot % numSatPerPlane) + numSatPerPlane) % numSatPerPlane;
+    return plane * numSatPerPlane + slot;
+}
+
+void WalkerNetwork::connect(int a, int b, const char *linkStyle)
+{
+    if (usedPorts[a] == NUM_PORTS || usedPorts[b] == NUM_PORTS)
+        throw cRuntimeError("WalkerLEO: more than %d ISLs at %s or %s",
+                NUM_PORTS, nodes[a]->getFullPath().c_str(), nodes[b]->getFullPath().c_str());
+    int portA = usedPorts[a]++;
+    int portB = usedPorts[b]++;
+
+    // a channel for each direction, as a NED <--> connection has
+    this->connectGates(nodes[a]->gateHalf("port", cGate::OUTPUT, portA), nodes[b]->gateHalf("port", cGate::INPUT, portB), linkStyle);
+    this->connectGates(nodes[b]->gateHalf("port", cGate::OUTPUT, portB), nodes[a]->gateHalf("port", cGate::INPUT, portA), linkStyle);
+}
+
+void WalkerNetwork::connectGates(cGate *src, cGate *dest, const char *linkStyle)
+{
+    // like the C/Circular channel types of NetLEO; initialized with the network
+    cChannel *channel = cChannelType::get("node.OrbitalChannel")->create("channel");
+    src->connectTo(dest, channel, true);
+    channel->par("delay").setDoubleValue(par("hoptime").doubleValueInUnit("s"));
+    channel->par("datarate").setDoubleValue(par("bandwidthMbps").doubleValueInUnit("bps"));
+    channel->par("geometricDelay").setBoolValue(par("orbitalDelay"));
+    channel->finalizeParameters();
+    channel->getDisplayString().parse(linkStyle);
+}
@@ -16,9 +16,17 @@
 #include <omnetpp.h>
 #include <fstream>
 #include "Packet_m.h"
+#include "ConstellationConfig.h"
+#include "ScenarioStore.h"
+#include "SwarmMembership.h"
+#include "RoutingDatabase.h"
+#include "SequenceWindow.h"
+#include "ResultWriter.h"
+#include "SyncCollector.h"
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <unordered_map>
 #include <stdexcept>
 using namespace omnetpp;
@@ -28,6 +36,16 @@ using namespace omnetpp;
 #define EAST 3
 #define WEST 4
 
+// the direction of LPVS along the planes: the backbone goes forward from
+// the sender, and the edge satellite of the swarm (v, or u when going left)
+// doesn't send backward. Baked into the handlers as a template parameter.
+template <bool GoLeft>
+struct LpvsDirection
+{
+    static const int forward = GoLeft ? DOWN : UP;
+    static const int backward = GoLeft ? UP : DOWN;
+    static int edge(Packet *pk) {return GoLeft ? pk->getU() : pk->getV();}
+};
 
 /**
  * Generates traffic for the network.
@@ -36,7 +54,9 @@ class App : public cSimpleModule
 {
   private:
     // configuration
+    ConstellationConfig config;
     int myAddress;
+    int myIndex; // dense id of this satellite, see RoutingDatabase
     int myTTL;
     int myPlane;
     int myOrensIndex;
@@ -44,13 +64,38 @@ class App : public cSimpleModule
     int numPktReceived;
     int numPktSent;
     int numPktperMsg;
-    std::unordered_map<int, std::pair<bool, int>>  neighbors; // neighbors of the module, {address, {connected, direction}}}
-    std::vector<std::tuple<double, double, int, int>> connectionsEvents; // hold the next reconnection and disconnections of the module
+    // the ISL of the module in every direction, see getNeighbors()
+    struct Neighbor
+    {
+        int address;   // -1 if there is no neighbor in this direction
+        int index;     // dense id of the neighbor
+        int gateIndex; // index of the port gate of the node leading to the neighbor
+        cGate *queueGate; // directIn gate of the queue of the ISL
+        bool connected;
+    };
+    Neighbor neighbors[WEST + 1]; // indexed by UP/DOWN/EAST/WEST, slot 0 is unused
+    bool directForwarding; // send to the queues directly instead of through Routing
+    bool fragmentTrains;   // send all the fragments of a message in one packet
+    ScenarioStore *scenario; // shared, parse-once view of the scenario sheets
+    SwarmMembership *membership; // shared view of the active set and the swarm geometry
+    RoutingDatabase *routingDatabase; // told about the link events, for the traffic that goes through Routing
+    ResultWriter *resultWriter; // buffered outfiles/recvN.csv and sentN.csv
+    SyncCollector *syncCollector; // told about the generated and received fragments
+    int recvStream; // -1 until the first line is written
+    int sentStream;
+    std::ostringstream resultLine;
+    const std::vector<ConnectionEvent> *connectionsEvents; // hold the reconnection and disconnections of the module, sorted by start time
+    size_t nextConnection; // first connection that didn't happen yet
+    std::vector<std::pair<double, int>> disconnections; // {stop, neighbor} of the connections, sorted by stop time
+    size_t nextDisconnection; // first disconnection that didn't happen yet
     std::vector<std::tuple<int, int>> orensMapping;
     std::vector<int> activeAddresses;
-    std::unordered_map<int, std::pair<int, int>>  activeAddressesTimes;
-    std::vector<std::vector<int>> traffic;  // [time,is_val_north,traffic]
-    std::unordered_map<std::string,bool> activeTraffics;  // activeAddress,Time->bool
+    const SatelliteTimes *activeAddressesTimes;
+    const std::vector<TrafficRecord> *traffic;  // [time,is_val_north,traffic], NULL if not active
+    size_t nextTraffic; // first traffic record that wasn't generated yet
+    std::unordered_map<int, SequenceWindow> seenTraffics;  // dense id of the source -> fragments already received from it, only for the sources heard from
+    long dedupWindow;  // size of the windows in seenTraffics
+    int nextSeqNum;    // sequence number of the next fragment generated here
 
 
     // state
@@ -60,6 +105,8 @@ class App : public cSimpleModule
     cMessage *activeIn;
     cMessage *activeOut;
     int is_val_north;
+    bool wasActive; // was active once, drawn as inactive after it leaves
+    mutable bool displayChanged; // the display strings must be updated on the next refreshDisplay()
 
 //    // Changeable parameters
 ////    bool goLeft = false;
@@ -83,26 +130,16 @@ class App : public cSimpleModule
     virtual void getOrensMapping();
     virtual void getNeighbors();
     virtual void getConnections();
+    virtual void scheduleNextConnection();
+    virtual void scheduleNextDisconnection();
     virtual void getCSVdata();
-    virtual void removeRedundancy();
     virtual void extractSatelliteTimes();
-    virtual void extractTrafficOfActive();
-
-    // getting states
-    virtual bool isNorth(int satAddress);
-    virtual std::vector<int> getASorMAS(bool giveAS);
-    virtual std::vector<int> getAPorMAP(bool giveAP);
-    virtual std::vector<int> getAPS();
-
-    // calculate for algo
-    virtual std::vector<int> calculateVU();
-    virtual std::vector<int> calculateb1b2();
-    virtual int calculateJ(int vu);
 
     // update function / GUIS
     virtual void updateIsValNorth(int change);
     virtual void updateGUI(Packet* pk);
     virtual void changeActiveStatus(bool status);
+    virtual void refreshDisplay() const override;
 
     // config
     virtual void disconnectWith(int neighborAddr);
@@ -113,9 +150,10 @@ class App : public cSimpleModule
     virtual bool doesHaveInterPlane(int address);
     virtual bool doesOrenIndexHaveInterPlane(int orenIndex);
 
-    virtual Packet* generateNewPacket(int collectedData, int numPktperMsg); //new
+    virtual Packet* generateNewPacket(int collectedData, int numPktperMsg, int numFragments = 1); //new
 //    virtual Packet* generateNewPacket(int collectedData);//old
     virtual int getISL(int to);
+    virtual bool isNewTraffic(int srcIndex, int seqNum);
     virtual int neighborDirection(int neighborAddr);
     virtual bool isDirectionFailed(int dir);
 
@@ -127,6 +165,12 @@ class App : public cSimpleModule
 
     virtual void sendPacket(Packet *pk, int direction);
 
+    // LPVS routing, specialized for the direction
+    template <bool GoLeft> void sendGenerated(Packet *pk);
+    template <bool GoLeft> void handleActivePacket(Packet *pk);
+    template <bool GoLeft> void handleProxyPacket(Packet *pk);
+    virtual void recordReception(Packet *pk);
+
 };
 
 Define_Module(App);
@@ -134,11 +178,23 @@ Define_Module(App);
 
 App::App()
 {
+    scenario = NULL;
+    membership = NULL;
+    routingDatabase = NULL;
+    resultWriter = NULL;
+    syncCollector = NULL;
+    recvStream = -1;
+    sentStream = -1;
+    connectionsEvents = NULL;
+    activeAddressesTimes = NULL;
+    traffic = NULL;
     generatePacket = NULL;
     controlConnect = NULL;
     controlDisconnect = NULL;
     activeIn = NULL;
     activeOut= NULL;
+    wasActive = false;
+    displayChanged = true;
 }
 
 App::~App()
@@ -176,23 +232,31 @@ void App::initialize()
     numPktperMsg =  0;
     numPktReceived = 0;
     numPktSent = 0;
+    nextSeqNum = 0;
+    nextConnection = 0;
+    nextDisconnection = 0;
+    nextTraffic = 0;
     isActive = false;
+    scenario = check_and_cast<ScenarioStore *>(getParentModule()->getParentModule()->getSubmodule("scenario"));
+    membership = check_and_cast<SwarmMembership *>(getParentModule()->getParentModule()->getSubmodule("membership"));
+    routingDatabase = check_and_cast<RoutingDatabase *>(getParentModule()->getParentModule()->getSubmodule("routingDatabase"));
+    resultWriter = check_and_cast<ResultWriter *>(getParentModule()->getParentModule()->getSubmodule("resultWriter"));
+    syncCollector = check_and_cast<SyncCollector *>(getParentModule()->getParentModule()->getSubmodule("syncCollector"));
+    config = ConstellationConfig::fromNetwork(getParentModule()->getParentModule());
     myAddress = par("address");
+    myIndex = routingDatabase->getNodeIndex(myAddress);
     myTTL = par("ttl");
-    EV << myAddress << endl;
-    myPlane = (myAddress) / 100;
+    dedupWindow = par("dedupWindow");
+    fragmentTrains = par("fragmentTrains");
+    directForwarding = getParentModule()->par("directForwarding");
+    EV_DEBUG << myAddress << endl;
+    myPlane = config.planeOf(myAddress);
     myOrensIndex = this->convertToOrensIndex(myAddress);
-    (myAddress % 100 > 10 || myAddress % 100 < 3) ? this->updateIsValNorth(1) : this->updateIsValNorth(0);
+    (config.slotOf(myAddress) > 10 || config.slotOf(myAddress) < 3) ? this->updateIsValNorth(1) : this->updateIsValNorth(0);
     this->getNeighbors();
     this->getConnections();
     this->getOrensMapping();
     this->extractSatelliteTimes();
-    // display my address
-    std::string disp = "(" + std::to_string(myAddress) + "), " + std::to_string(myPlane)+ "," + std::to_string(myOrensIndex);
-    getParentModule()->getDisplayString().setTagArg("t",0,disp.c_str());
-    getParentModule()->getDisplayString().setTagArg("t",1,"t");
-    //getParentModule()->getDisplayString().setTagArg("t",2,"black");
-
     // Color the node to be green, if this satellite is an active one
     // get all the active satellites addresses into a vector 'activeAddresses'
     // Read the CSV data as well
@@ -205,20 +269,17 @@ void App::initialize()
         if (myAddress == atoi(tokenSat))
         {
             // If I'm an active satellite, let me schedule my exit end enter time
+            auto myTimes = activeAddressesTimes->find(myAddress);
             activeIn = new cMessage();
-            scheduleAt(activeAddressesTimes[myAddress].first, activeIn);
+            scheduleAt(myTimes != activeAddressesTimes->end() ? myTimes->second.first : 0, activeIn);
             activeOut = new cMessage();
-            scheduleAt(activeAddressesTimes[myAddress].second, activeOut);
+            scheduleAt(myTimes != activeAddressesTimes->end() ? myTimes->second.second : 0, activeOut);
 
 
             // I'm active so I have some data to send, read it
             this->getCSVdata();
-            for (const auto& inner_vec : traffic) {
-              // Iterate over each element of the inner vector
-              for (const auto& elem : inner_vec) {
-                EV << elem << " ";
-              }
-              EV << std::endl;
+            for (const auto& record : *traffic) {
+                EV_DEBUG << record.time << " " << record.isValNorth << " " << record.amount << " " << std::endl;
             }
         }
     }
@@ -232,53 +293,28 @@ void App::initialize()
     scheduleAt(simTime(), generatePacket);
 
     // generate the next event for reconnection
-    if (connectionsEvents.size() > 0){
+    if (connectionsEvents->size() > 0){
         controlConnect = new Control();
-        controlConnect->setTime(std::get<0>(connectionsEvents[0]));
-        controlConnect->setAddress( std::get<2>(connectionsEvents[0]));
-        controlConnect->setIsAsending(std::get<3>(connectionsEvents[0]));
-        scheduleAt(controlConnect->getTime(), controlConnect);
+        this->scheduleNextConnection();
 
         controlDisconnect = new Control();
-        controlDisconnect->setTime(std::get<1>(connectionsEvents[0]));
-        controlDisconnect->setAddress( std::get<2>(connectionsEvents[0]));
-        scheduleAt(controlDisconnect->getTime(), controlDisconnect);}
+        this->scheduleNextDisconnection();}
 
 
     // disconnect with East and West
-    for (const auto& item : neighbors)
+    for (int dir = EAST; dir <= WEST; dir++)
     {
-        if (item.second.second == EAST || item.second.second == WEST){
-            this->disconnectWith(item.first);
+        if (neighbors[dir].address != -1){
+            this->disconnectWith(neighbors[dir].address);
         }
     }
 
-//     hide Up and Down connection
-    for (const auto& item : neighbors)
-    {
-        if (item.second.second == UP || item.second.second == DOWN)
-        {
-            for (int i = 0; i < this->getParentModule()->gateSize("port$o"); i++)
-            {
-                cGate *gate = this->getParentModule()->gate("port$o", i);
-                cModule *connectedModule = gate->getNextGate()->getOwnerModule();
-                if (connectedModule->par("address").intValue() == item.first)
-                {
-                    cDisplayString& connDispStr = gate->getDisplayString();
-                    connDispStr.parse("ls=gray,0.5,d");
-                }
-            }
-        }
+    EV_DEBUG << myOrensIndex << "{ ";
+    for (int dir = UP; dir <= WEST; dir++) {
+        if (neighbors[dir].address != -1)
+            EV_DEBUG << neighbors[dir].address << ": (" << neighbors[dir].connected << ", " << dir << ") ";
     }
-
-
-    EV << std::to_string(myOrensIndex) << "{ ";
-    for (auto it = neighbors.begin(); it != neighbors.end(); ++it) {
-        const auto& key = it->first;
-        const auto& value = it->second;
-        EV << key << ": (" << value.first << ", " << value.second << ") ";
-    }
-    EV << "}\n";
+    EV_DEBUG << "}\n";
 
     // register signals for statistics afterwards
     endToEndDelaySignal = registerSignal("endToEndDelay");
@@ -291,94 +327,58 @@ void App::initialize()
 
 void App::handleMessage(cMessage* msg)
 {
-    int maxBitsperMsg = getParentModule()->getParentModule()->par("maxBitsperMsg");;
-    bool goLeft = getParentModule()->getParentModule()->par("goLeft");;
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    int minPlane = 3;
-    int maxPlane = 5;
-    if (scenerio_num == 2){
-        int minPlane = 1;
-    }
-    else if (scenerio_num == 3){
-        int minPlane = 1;
-        int maxPlane = 3;
-    }
-
     // Check if it's time to handle some internal event
     if (msg == generatePacket)
     {
         // Get the current simulation time
         simtime_t currentTime = simTime();
 
-        // Loop through the vector of traffic and handle any that occur at the current time
-        for (auto it = traffic.begin(); it != traffic.end();)
+        // Loop through the traffic records and handle any that occur at the current time
+        while (traffic != NULL && nextTraffic < traffic->size())
         {
-            if ((simtime_t)(*it)[0] == currentTime)
+            const TrafficRecord& record = (*traffic)[nextTraffic];
+            if ((simtime_t)record.time == currentTime)
             {
                 // Change the status
-                this->updateIsValNorth((*it)[1]);
+                this->updateIsValNorth(record.isValNorth);
 
                 // Generate traffic if necessary
-                if ((*it)[2] > 0)
+                if (record.amount > 0)
                 {
                     // If I'm sending traffic obviously I'm active
                     this->changeActiveStatus(true);
 
-                    char to_bubble[64];
-                    int trafficAmount = (*it)[2];
+                    int trafficAmount = record.amount;
                     int numPktperMsg = 1; // new
 
                     // Algorithm 1 Satellite LPVS East BB Routing
-                    while (trafficAmount > maxBitsperMsg)
+                    while (!fragmentTrains && trafficAmount > config.maxBitsPerMsg)
                     {
-                        Packet *pk = generateNewPacket(maxBitsperMsg, numPktperMsg);
+                        Packet *pk = generateNewPacket(config.maxBitsPerMsg, numPktperMsg);
                         numPktperMsg++; // new
                         numPktSent++;
-                        trafficAmount -= maxBitsperMsg;
-
-                        if (!goLeft)
-                        {
-                            sendPacket(pk, UP);
-                            if (myOrensIndex != pk->getV())
-                            {
-                                sendPacket(pk, DOWN);
-                            }
-                        }
-                        else if (goLeft)
-                        {
-                            sendPacket(pk, DOWN);
-                            if (myOrensIndex != pk->getU())
-                            {
-                                sendPacket(pk, UP);
-                            }
-                        }
+                        trafficAmount -= config.maxBitsPerMsg;
+                        if (config.goLeft)
+                            this->sendGenerated<true>(pk);
+                        else
+                            this->sendGenerated<false>(pk);
                     }
 
-                    Packet *pk = generateNewPacket(trafficAmount, numPktperMsg);
-                    numPktSent++;
-                    if (!goLeft)
-                    {
-                        sendPacket(pk, UP);
-                        if (myOrensIndex != pk->getV())
-                        {
-                            sendPacket(pk, DOWN);
-                        }
-                    }
-                    else if (goLeft)
-                    {
-                        sendPacket(pk, DOWN);
-                        if (myOrensIndex != pk->getU())
-                        {
-                            sendPacket(pk, UP);
-                        }
-                    }
+                    // the rest, or the whole message as one fragment train
+                    int numFragments = (trafficAmount + config.maxBitsPerMsg - 1) / config.maxBitsPerMsg;
+                    Packet *pk = generateNewPacket(trafficAmount, numPktperMsg, numFragments);
+                    numPktSent += numFragments;
+                    if (config.goLeft)
+                        this->sendGenerated<true>(pk);
+                    else
+                        this->sendGenerated<false>(pk);
 
                     this->writeSentCSV();
                     delete pk;
                 }
 
-                // Remove the event from the vector
-                it = traffic.erase(it);
+                // Move on to the next record
+                nextTraffic++;
             }
             else
             {
@@ -388,9 +388,9 @@ void App::handleMessage(cMessage* msg)
         }
 
         // Schedule the next event if there are more events
-        if (!traffic.empty())
+        if (traffic != NULL && nextTraffic < traffic->size())
         {
-            simtime_t nextTime = traffic.front()[0];
+            simtime_t nextTime = (*traffic)[nextTraffic].time;
             scheduleAt(nextTime, generatePacket);
         }
     }
@@ -402,39 +402,15 @@ void App::handleMessage(cMessage* msg)
         this->reconnectWith(controlConnect->getAddress());
         this->updateIsValNorth(controlConnect->getIsAsending());
 
-        // schedule the next connect event
-        if (connectionsEvents.size() > 0)
-        {
-            for(int i=0; i<connectionsEvents.size();i++)
-            {
-                if(((std::get<0>(connectionsEvents[i]))) > controlConnect->getTime())
-                {
-                    controlConnect->setTime(std::get<0>(connectionsEvents[i]));
-                    controlConnect->setAddress( std::get<2>(connectionsEvents[i]));
-                    controlConnect->setIsAsending(std::get<3>(connectionsEvents[i]));
-                    scheduleAt(controlConnect->getTime(), controlConnect);
-                    break;
-                }
-            }
-        }
-        //}
+        nextConnection++;
+        this->scheduleNextConnection();
     }
     else if (msg == controlDisconnect)
     {
         // disconnection event
         this->disconnectWith(controlDisconnect->getAddress());
-        // schedule the next reconnection event, if there is still new events
-        if(!connectionsEvents.empty()){
-            connectionsEvents.erase(connectionsEvents.begin());
-        }
-        //schedule new disconnection
-        if(!connectionsEvents.empty())
-        {
-            controlDisconnect->setTime(std::get<1>(connectionsEvents[0]));
-            controlDisconnect->setAddress( std::get<2>(connectionsEvents[0]));
-            scheduleAt(controlDisconnect->getTime(), controlDisconnect);
-        }
-        //}
+        nextDisconnection++;
+        this->scheduleNextDisconnection();
     }
     else if(msg == activeIn)
     {
@@ -448,624 +424,276 @@ void App::handleMessage(cMessage* msg)
     }
     else
     {
-        char to_bubble[64];
         Packet *pk = check_and_cast<Packet *>(msg);
-        EV << "HANDLE MSG" << endl;
-        // Handle incoming packet
+        EV_DEBUG << "HANDLE MSG" << endl;
+        // Handle incoming packet, on the path specialized for the LPVS direction
         if (isActive)
         {
-            if(!goLeft)
-            {
-                // Algorithm 1 Satellite LPVS East BB Routing
-                // Active Satellite Received Data.
-                /*
-                 * 3) When Reading Msg from downISL:
-                    Decrease T T L, send on UpISL.
-                    4) When Reading Msg from upISL:
-                    If indexonPlane! = v then decrease T T L, send
-                    Msg on downISL.
-                 */
-                // check if I already saw this messegeEV << "Active recieved: " << std::to_string(myAddress) << endl;
-                EV << "received packet " << pk->getName() << " after " << pk->getHopCount() << "hops" << endl;
-
-                // check if I already saw this messege
-                std::string key = std::to_string(pk->getSrcAddr()) + "," + std::to_string(std::lround(pk->getCreationTime().dbl())) + ","+std::to_string(pk->getnumPktperMsg()); //new
-
-                // if I didnt saw this messege and its not mine msg then update statistics
-                if(this->activeTraffics[key]==false && this->myAddress != pk->getSrcAddr())
-                {   // update statistics
-                    EV << "New data" << endl;
-                    numPktReceived += 1;
-                    emit(endToEndDelaySignal, simTime() - pk->getCreationTime());
-                    emit(hopCountSignal, pk->getHopCount());
-                    emit(sourceAddressSignal, pk->getSrcAddr());
-
-                    // update GUI given the packet
-//                    this->updateGUI(pk);
-                    EV << key << ": " << std::boolalpha << this->activeTraffics[key] << endl;
-                    this->activeTraffics[key]=true;
-                    EV << key << ": " << std::boolalpha << this->activeTraffics[key] << endl;
-
-                    // record to CSV
-                    writeRecvCSV(pk->getCreationTime().dbl(), pk->getSrcAddr(), (simTime() - pk->getCreationTime()).dbl(),pk->getnumPktperMsg(),pk->getHopCount(),pk->getBitLength());
-
-                }
-                else // I havn't seen the data
-                {
-                    EV << key << ": " << std::boolalpha << this->activeTraffics[key] << endl;
-                    EV << "Already saw this data" << endl;
-                }
-                //  When Reading Msg from downISL: Decrease TTL, send on upISL.
-                if(this->neighborDirection(pk->getIntermediateSrcAddr()) == DOWN)   // Reading Msg from downISL
-                {
-                    // Decrease TTL
-                    pk->setTTL(pk->getTTL() - 1);
-
-                    // send to Up ISL
-                    sendPacket(pk, UP);
-                }
-                else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == UP)   // Reading Msg from upISL
-                {
-                    //When Reading Msg from upISL: If indexonPlane! = v then decrease TTL, send Msg on downISL.
-                    if(myOrensIndex != pk->getV())
-                    {
-                        // Decrease TTL
-                        pk->setTTL(pk->getTTL() - 1);
-
-                        // send to Down ISL
-                        sendPacket(pk,DOWN);
-                    }
-                    else
-                    {
-                        sprintf(to_bubble, "Arrived! from: %d, NOT FORWARDING IM V", pk->getSrcAddr());
-//                        getParentModule()->bubble(to_bubble);
-                    }
-                }
-            }
-            else if(goLeft)
-                        {
-                            // Algorithm 1 Satellite LPVS East BB Routing
-                            // Active Satellite Received Data.
-                            /*
-                             * 3) When Reading Msg from downISL:
-                                Decrease T T L, send on upISL.
-                                4) When Reading Msg from downISL:
-                                If indexonPlane! = u then decrease T T L, send
-                                Msg on upISL.
-                             */
-
-                            // check if I already saw this messegeEV << "Active recieved: " << std::to_string(myAddress) << endl;
-                            EV << "received packet " << pk->getName() << " after " << pk->getHopCount() << "hops" << endl;
-                            std::string key = std::to_string(pk->getSrcAddr()) + "," + std::to_string(std::lround(pk->getCreationTime().dbl())) + ","+std::to_string(pk->getnumPktperMsg()); //new
-
-                            // if I didnt saw this messege and its not mine msg then update statistics
-                            if(this->activeTraffics[key]==false && this->myAddress != pk->getSrcAddr())
-                            {   // update statistics
-                                EV << "New data" << endl;
-                                numPktReceived += 1;
-                                emit(endToEndDelaySignal, simTime() - pk->getCreationTime());
-                                emit(hopCountSignal, pk->getHopCount());
-                                emit(sourceAddressSignal, pk->getSrcAddr());
-
-                                // update GUI given the packet
-//                                this->updateGUI(pk);
-                                EV << key << ": " << std::boolalpha << this->activeTraffics[key] << endl;
-                                this->activeTraffics[key]=true;
-                                EV << key << ": " << std::boolalpha << this->activeTraffics[key] << endl;
-
-                                // record to CSV
-                                writeRecvCSV(pk->getCreationTime().dbl(), pk->getSrcAddr(), (simTime() - pk->getCreationTime()).dbl(),pk->getnumPktperMsg(),pk->getHopCount(),pk->getBitLength());
-
-                            }
-                            else // I havn't seen the data
-                            {
-                                EV << key << ": " << std::boolalpha << this->activeTraffics[key] << endl;
-                                EV << "Already saw this data" << endl;
-                            }
-                            //  When Reading Msg from upISL: Decrease TTL, send on downISL.
-                            if(this->neighborDirection(pk->getIntermediateSrcAddr()) == UP)   // Reading Msg from upISL
-                            {
-                                // Decrease TTL
-                                pk->setTTL(pk->getTTL() - 1);
-                                sendPacket(pk, DOWN);
-                            }
-                            else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == DOWN)   // Reading Msg from downISL
-                            {
-                                //When Reading Msg from upISL: If indexonPlane! = u then decrease TTL, send Msg on downISL.
-                                if(myOrensIndex != pk->getU())
-                                {
-                                    // Decrease TTL
-                                    pk->setTTL(pk->getTTL() - 1);
-
-                                    // send to Up ISL
-                                   sendPacket(pk,UP);
-                                }
-                                else // I am U
-                                {
-                                    sprintf(to_bubble, "Arrived! from: %d, NOT FORWARDING IM U", pk->getSrcAddr());
-//                                    getParentModule()->bubble(to_bubble);
-                                }
-                            }
-                        }
+            if (config.goLeft)
+                this->handleActivePacket<true>(pk);
+            else
+                this->handleActivePacket<false>(pk);
         }
-        else // not active
+        else
         {
-            if(!goLeft){
-                // not active satellite
-                // Algorithm 3 EBB - Proxy Routing with failed inter-ISLs
-                // Received Packet on proxy Satellite
-                EV << "proxy received: " << std::to_string(myAddress) << endl;
-                if(myOrensIndex != pk->getJ())
-                {
-                    EV << "my index:" << std::to_string(myOrensIndex) <<" is not j: " << std::to_string(pk->getJ()) << endl;
-                    EV << "Received from: " << std::to_string(this->neighborDirection(pk->getIntermediateSrcAddr())) << endl;
-
-                    if(pk->getTTL() <= 0)
-                    {
-                        EV << "TTL == 0" << endl;
-                        sprintf(to_bubble, "TTL = 0, DISCARDING");
-                        getParentModule()->bubble(to_bubble);
-                        delete pk;
-                        return;
-                    }
-                    // Decrease TTL
-                    pk->setTTL(pk->getTTL() - 1);
-
-                    // If Received from downISL :
-                    if (this->neighborDirection(pk->getIntermediateSrcAddr()) == DOWN)
-                    {
-                        EV << "Received from downISL: " << std::to_string((this->neighborDirection(pk->getIntermediateSrcAddr()))) << endl;
-                        // If reachedj = False; then send on upISL
-                        if (pk->getReachedJ() == false)
-                        {
-                            EV << "packet didnt reach j" << endl;
-                            sendPacket(pk, UP);
-                        }
-                        else // If reachedj and message from down;
-                        {
-                            EV << "packet did reach j" << endl;
-                            if (pk->getEfailed()){
-                                sendPacket(pk, EAST);
-                            }
-                            if (pk->getWfailed()){
-                                sendPacket(pk, WEST);
-                            }
-                            if (pk->getWfailed()||pk->getEfailed()){
-                                sendPacket(pk, UP);
-                            }
-                        }
-                    }
-
-                    else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == EAST){
-                                pk->setEfailed(false);
-                                if(this->isDirectionFailed(WEST)){
-                                    pk->setWfailed(true);
-                                }
-                                else{
-                                    sendPacket(pk, WEST);
-                                    }
-                                sendPacket(pk, DOWN);
-                                }
-                    else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == WEST){
-                                pk->setWfailed(false);
-                                if(this->isDirectionFailed(EAST)){
-                                    pk->setEfailed(true);
-                                }
-                                else{
-                                    sendPacket(pk, EAST);
-                                    }
-                                sendPacket(pk, DOWN);
-                                sendPacket(pk, UP);//special
-                                pk->setEfailed(false);//special
-                                }
-                    else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == UP)
-                    {
-                       if (pk->getEfailed()){
-                           sendPacket(pk, EAST);
-                           }
-
-                       if (pk->getWfailed()){
-                           sendPacket(pk, WEST);
-                           }
-
-                       if (pk->getV() != this->myOrensIndex)
-                       {
-                           sendPacket(pk, DOWN);
-                    }
-
-                }
-                }
-
-                else //If indexOnPlane == j
-                {
-                    EV << "my index:" << std::to_string(myOrensIndex) <<" it is j: " << std::to_string(pk->getJ()) << endl;
-                    if(pk->getTTL() <= 0)
-                    {
-                        EV << "TTL == 0" << endl;
-                        sprintf(to_bubble, "TTL = 0, DISCARDING");
-                        getParentModule()->bubble(to_bubble);
-                        return;
-                    }
-                    // Decrease TTL
-                    pk->setTTL(pk->getTTL() - 1);
-                    if(this->myPlane == minPlane){
-                        pk->setWfailed(false);
-                    }
-                    if(this->myPlane == maxPlane){
-                        pk->setEfailed(false);
-                    }
-                    //set reached j == true
-                    pk->setReachedJ(true);
-                    EV << "received from:" << std::to_string((this->neighborDirection(pk->getIntermediateSrcAddr()))) << endl;
-                    // If Received from down ISL :
-                    if (this->neighborDirection(pk->getIntermediateSrcAddr()) == UP)
-                    {
-                        sendPacket(pk, DOWN);
-
-                        if(pk->getEfailed()){
-                            sendPacket(pk, EAST);
-                        }
-                        if(pk->getEfailed()||pk->getWfailed()){
-                            sendPacket(pk, UP);
-                        }
-
-                    }
-
-
-                    else if (this->neighborDirection(pk->getIntermediateSrcAddr()) == DOWN) // If Received from down ISL :
-                    {
-                        EV << "Received from DownISL: " << std::to_string((this->neighborDirection(pk->getIntermediateSrcAddr()))) << endl;
-                        if(this->isDirectionFailed(EAST))
-                        {
-                            EV << "Sending on UpISL because direction EAST is failed" << endl;
-                            // set EFailed, send on downISL.
-                            pk->setEfailed(true);}
-                        else
-                        {
-                            EV << "Sending on EastISL" << endl;
-                            // send to east ISL
-                            sendPacket(pk, EAST);
-                        }
-                        sendPacket(pk, UP);
-                        }
-                    else // not from up
-                      {
-                          EV << "Received from east ISL or received from downISL and Wfailed" << endl;
-                          std::vector<int> APS = this->getAPS();
-                          // clear Efailed
-                          pk->setEfailed(false);
-                          sendPacket(pk, UP);
-                          sendPacket(pk, DOWN);
-                    }
-                }
-            }
-
-            if(goLeft){
-                // not active satellite
-                // Algorithm 3 EBB - Proxy Routing with failed inter-ISLs
-                // Received Packet on proxy Satellite
-                EV << "proxy recieved: " << std::to_string(myAddress) << endl;
-                if(myOrensIndex != pk->getJ())
-                {
-                    EV << "my index:" << std::to_string(myOrensIndex) <<" is not j: " << std::to_string(pk->getJ()) << endl;
-                    EV << "Received from: " << std::to_string(this->neighborDirection(pk->getIntermediateSrcAddr())) << endl;
-
-                    if(pk->getTTL() <= 0)
-                    {
-                        EV << "TTL == 0" << endl;
-                        sprintf(to_bubble, "TTL = 0, DISCARDING");
-                        getParentModule()->bubble(to_bubble);
-                        delete pk;
-                        return;
-                    }
-                    // Decrease TTL
-                    pk->setTTL(pk->getTTL() - 1);
-
-                    // If Received from upISL :
-                    if (this->neighborDirection(pk->getIntermediateSrcAddr()) == UP)
-                    {
-                        EV << "Received from upISL: " << std::to_string((this->neighborDirection(pk->getIntermediateSrcAddr()))) << endl;
-                        // If reachedj = False; then send on downISL
-                        if (pk->getReachedJ() == false)
-                        {
-                            EV << "packet didnt reach j" << endl;
-                            sendPacket(pk, DOWN);
-                        }
-                        else // If reachedj and message from up;
-                        {
-                            EV << "packet did reach j" << endl;
-                            if (pk->getEfailed()){
-                                sendPacket(pk, EAST);
-                            }
-                            if (pk->getWfailed()){
-                                sendPacket(pk, WEST);
-                            }
-                            if (pk->getWfailed()||pk->getEfailed()){
-                                sendPacket(pk, DOWN);
-                            }
-                        }
-                    }
-
-                    else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == EAST){
-                                pk->setEfailed(false);
-                                if(this->isDirectionFailed(WEST)){
-                                    pk->setWfailed(true);
-                                }
-                                else{
-                                    sendPacket(pk, WEST);
-                                    }
-                                sendPacket(pk, UP);
-                                }
-                    else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == WEST){
-                                pk->setWfailed(false);
-                                if(this->isDirectionFailed(EAST)){
-                                    pk->setEfailed(true);
-                                }
-                                else{
-                                    sendPacket(pk, EAST);
-                                    }
-                                sendPacket(pk, UP);
-                                sendPacket(pk, DOWN);//special
-                                pk->setEfailed(false);//special
-
-                                }
-                    else if(this->neighborDirection(pk->getIntermediateSrcAddr()) == DOWN)
-                    {
-                       if (pk->getEfailed()){
-                           sendPacket(pk, EAST);
-                           }
-
-                       if (pk->getWfailed()){
-                           sendPacket(pk, WEST);
-                           }
-
-                       if (pk->getU() != this->myOrensIndex)
-                       {
-                           sendPacket(pk, UP);
-                    }
-
-                }
-                }
-
-                else //If indexOnPlane == j
-                {
-                    EV << "my index:" << std::to_string(myOrensIndex) <<" it is j: " << std::to_string(pk->getJ()) << endl;
-                    if(pk->getTTL() <= 0)
-                    {
-                        EV << "TTL == 0" << endl;
-                        sprintf(to_bubble, "TTL = 0, DISCARDING");
-                        getParentModule()->bubble(to_bubble);
-                        return;
-                    }
-                    // Decrease TTL
-                    pk->setTTL(pk->getTTL() - 1);
-                    if(this->myPlane == minPlane){
-                                                pk->setWfailed(false);
-                    }
-                    if(this->myPlane == maxPlane){
-                        pk->setEfailed(false);
-                    }
-                    //set reached j == true
-                    pk->setReachedJ(true);
-                    EV << "received from:" << std::to_string((this->neighborDirection(pk->getIntermediateSrcAddr()))) << endl;
-                    // If Received from down ISL :
-                    if (this->neighborDirection(pk->getIntermediateSrcAddr()) == DOWN)
-                    {
-                        sendPacket(pk, UP);
-
-                        if(pk->getEfailed()){
-                            sendPacket(pk, EAST);
-                        }
-                        if(pk->getEfailed()||pk->getWfailed()){
-                            sendPacket(pk, DOWN);
-                        }
-
-                    }
-
-
-                    else if (this->neighborDirection(pk->getIntermediateSrcAddr()) == UP) // If Received from up ISL :
-                    {
-                        EV << "Received from UpISL: " << std::to_string((this->neighborDirection(pk->getIntermediateSrcAddr()))) << endl;
-                        if(this->isDirectionFailed(EAST))
-                        {
-                            EV << "Sending on DownISL because direction EAST is failed" << endl;
-                            // set EFailed, send on downISL.
-                            pk->setEfailed(true);}
-                        else
-                        {
-                            EV << "Sending on EastISL" << endl;
-                            // send to east ISL
-                            sendPacket(pk, EAST);
-                        }
-                        sendPacket(pk, DOWN);
-                        }
-                    else // not from up
-                      {
-                          EV << "Received from east ISL or received from downISL and Wfailed" << endl;
-                          std::vector<int> APS = this->getAPS();
-                          // clear Efailed
-                          pk->setEfailed(false);
-                          sendPacket(pk, DOWN);
-                          sendPacket(pk, UP);
-                    }
-                }
-            }
+            if (config.goLeft)
+                this->handleProxyPacket<true>(pk);
+            else
+                this->handleProxyPacket<false>(pk);
         }
         delete pk;
     }
 }
 
-
-void App::getCSVdata()
+template <bool GoLeft>
+void App::sendGenerated(Packet *pk)
 {
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    std::string traffic_gen = "sheets/scenerio" + std::to_string(scenerio_num) + "_traffic_gen.csv";
-    std::ifstream file(traffic_gen);
-//    std::ifstream file("sheets/scenerio1_traffic_gen.csv"); // open the file for reading
-    std::string line; // variable to store each line of the file
-
-    // skip the first line of the file
-    getline(file, line);
+    // forward along the plane, and backward unless I am the edge of the swarm
+    typedef LpvsDirection<GoLeft> Lpvs;
+    sendPacket(pk, Lpvs::forward);
+    if (myOrensIndex != Lpvs::edge(pk))
+    {
+        sendPacket(pk, Lpvs::backward);
+    }
+}
 
-    // loop through each line of the file
-    while (getline(file, line))
+void App::recordReception(Packet *pk)
+{
+    // check if I already saw this messege
+    // if I didnt saw this messege and its not mine msg then update statistics,
+    // for every fragment of a fragment train (they all arrive with the train)
+    EV_DEBUG << "received packet " << pk->getName() << " after " << pk->getHopCount() << "hops" << endl;
+    int numFragments = pk->getNumFragments();
+    for (int i = 0; i < numFragments; i++)
     {
-        std::stringstream ss(line); // create a stringstream from the line
-        std::string cell; // variable to store each field of the line
-        int col = 0, address = 0, time = 0, amount = 0;
-        std::string north;
-
-        // loop through each field of the line
-        while (std::getline(ss, cell, ',')) {
-                    ++col;
-                    if (col == 1) {
-                        address = std::stoi(cell);
-                    } else if (col == 2) {
-                        time = std::stoi(cell);
-                    } else if (col == 3) {
-                        north = cell;
-                    } else if (col == 4) {
-                        amount = std::stoi(cell);
-                    }
-                    cell.clear();
-                }
-        // if the 4rd field matches the condition, store the 1th, 2th, and 3th fields of the line as int types
-        if(address == myAddress && amount > 0)
+        int seqNum = pk->getSeqNum() + i;
+        if(this->myAddress != pk->getSrcAddr() && this->isNewTraffic(pk->getSrcIndex(), seqNum))
+        {   // update statistics
+            EV_DEBUG << "New data" << endl;
+            numPktReceived += 1;
+            emit(endToEndDelaySignal, simTime() - pk->getCreationTime());
+            emit(hopCountSignal, pk->getHopCount());
+            emit(sourceAddressSignal, pk->getSrcAddr());
+            syncCollector->fragmentReceived(pk->getSrcAddr(), seqNum, myAddress, pk->getHopCount());
+
+            // update GUI given the packet
+//            this->updateGUI(pk);
+            // record to CSV
+            int bitLength = i + 1 < numFragments ? pk->getFragmentBits() : pk->getBitLength() - (int64_t)(numFragments - 1) * pk->getFragmentBits();
+            writeRecvCSV(pk->getCreationTime().dbl(), pk->getSrcAddr(), (simTime() - pk->getCreationTime()).dbl(),pk->getnumPktperMsg() + i,pk->getHopCount(),bitLength);
+        }
+        else // I havn't seen the data
         {
-            int is_val_north;
-            (north == "True") ? (is_val_north = 1) : (is_val_north = 0);
-            std::vector<int> combined{time,is_val_north,amount};
-            traffic.push_back(combined);
+            EV_DEBUG << "Already saw this data" << endl;
         }
     }
-    // remove redundant vectors, most of the time there is no change, so keep only the changes
-    //this->removeRedundancy();
 }
 
-void App::removeRedundancy()
+template <bool GoLeft>
+void App::handleActivePacket(Packet *pk)
 {
-    // Sort the vector of vectors by time
-    std::sort(traffic.begin(), traffic.end(), [](const std::vector<int>& a, const std::vector<int>& b) {
-        // Compare the time field of each vector
-        return a[0] < b[0];
-    });
-
-    // Loop through the vector of vectors and remove redundant entries
-    int previousStatus = -1; // Initialize previousStatus to an invalid value
-    for (auto it = traffic.begin(); it != traffic.end(); ) {
-        // Check if the status field of the current vector is different from the previous one,
-        // or if the traffic field of the current vector is positive
-        if ((*it)[1] != previousStatus || (*it)[2] > 0) {
-            // Update previousStatus to the status of the current vector
-            previousStatus = (*it)[1];
-            // Move on to the next vector
-            ++it;
-        } else {
-            // Remove the current vector from the vector of vectors
-            it = traffic.erase(it);
+    // Algorithm 1 Satellite LPVS East BB Routing
+    // Active Satellite Received Data.
+    /*
+     * 3) When Reading Msg from downISL:
+        Decrease T T L, send on UpISL.
+        4) When Reading Msg from upISL:
+        If indexonPlane! = v then decrease T T L, send
+        Msg on downISL.
+     * (going left: up and down swapped, u instead of v)
+     */
+    typedef LpvsDirection<GoLeft> Lpvs;
+    this->recordReception(pk);
+
+    // sendPacket() changes the intermediate source, so take the direction first
+    int from = this->neighborDirection(pk->getIntermediateSrcAddr());
+    //  When Reading Msg from downISL: Decrease TTL, send on upISL.
+    if(from == Lpvs::backward)   // Reading Msg from downISL
+    {
+        // Decrease TTL
+        pk->setTTL(pk->getTTL() - 1);
+
+        // send to Up ISL
+        sendPacket(pk, Lpvs::forward);
+    }
+    else if(from == Lpvs::forward)   // Reading Msg from upISL
+    {
+        //When Reading Msg from upISL: If indexonPlane! = v then decrease TTL, send Msg on downISL.
+        if(myOrensIndex != Lpvs::edge(pk))
+        {
+            // Decrease TTL
+            pk->setTTL(pk->getTTL() - 1);
+
+            // send to Down ISL
+            sendPacket(pk, Lpvs::backward);
         }
     }
 }
 
-void App::extractTrafficOfActive()
+template <bool GoLeft>
+void App::handleProxyPacket(Packet *pk)
 {
-    int maxBitsperMsg = getParentModule()->getParentModule()->par("maxBitsperMsg");;
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    std::string traffic_gen = "sheets/scenerio" + std::to_string(scenerio_num) + "_traffic_gen.csv";
-    std::ifstream file(traffic_gen); // open the file for reading
-    std::string line; // variable to store each line of the file
-    std::vector<std::string> fields; // vector to store the fields of the current line
-
-    // skip the first line of the file
-    getline(file, line);
-
-    // loop through each line of the file
-    while (getline(file, line))
+    // not active satellite
+    // Algorithm 3 EBB - Proxy Routing with failed inter-ISLs
+    // Received Packet on proxy Satellite
+    // (the names below are for going right; going left, up and down are swapped and u replaces v)
+    typedef LpvsDirection<GoLeft> Lpvs;
+    EV_DEBUG << "proxy received: " << myAddress << endl;
+
+    // sendPacket() changes the intermediate source, so take the direction first
+    int from = this->neighborDirection(pk->getIntermediateSrcAddr());
+    if(myOrensIndex != pk->getJ())
     {
-        std::stringstream ss(line); // create a stringstream from the line
-        std::string field; // variable to store each field of the line
-        int field_count = 0; // variable to keep track of the current field number
-        bool match_condition = false; // variable to keep track of whether the 4th field matches the condition
+        EV_DEBUG << "my index:" << myOrensIndex <<" is not j: " << pk->getJ() << endl;
+        EV_DEBUG << "Received from: " << from << endl;
 
-        fields.clear(); // clear the vector of fields for the current line
+        if(pk->getTTL() <= 0)
+        {
+            EV_DEBUG << "TTL == 0" << endl;
+            getParentModule()->bubble("TTL = 0, DISCARDING");
+            return;
+        }
+        // Decrease TTL
+        pk->setTTL(pk->getTTL() - 1);
 
-        // loop through each field of the line
-        while (getline(ss, field, ','))
+        // If Received from downISL :
+        if (from == Lpvs::backward)
         {
-            field_count++; // increment the field count
-            if (field_count == 4)
+            EV_DEBUG << "Received from downISL: " << from << endl;
+            // If reachedj = False; then send on upISL
+            if (pk->getReachedJ() == false)
             {
-                // check if the 4th field is bigger than 0
-                if (std::stoi(field) > 0)
-                {
-                    match_condition = true;
+                EV_DEBUG << "packet didnt reach j" << endl;
+                sendPacket(pk, Lpvs::forward);
+            }
+            else // If reachedj and message from down;
+            {
+                EV_DEBUG << "packet did reach j" << endl;
+                if (pk->getEfailed()){
+                    sendPacket(pk, EAST);
                 }
+                if (pk->getWfailed()){
+                    sendPacket(pk, WEST);
+                }
+                if (pk->getWfailed()||pk->getEfailed()){
+                    sendPacket(pk, Lpvs::forward);
+                }
+            }
+        }
+        else if(from == EAST){
+            pk->setEfailed(false);
+            if(this->isDirectionFailed(WEST)){
+                pk->setWfailed(true);
+            }
+            else{
+                sendPacket(pk, WEST);
             }
-            fields.push_back(field); // store the field in the vector of fields for the current line
+            sendPacket(pk, Lpvs::backward);
+        }
+        else if(from == WEST){
+            pk->setWfailed(false);
+            if(this->isDirectionFailed(EAST)){
+                pk->setEfailed(true);
+            }
+            else{
+                sendPacket(pk, EAST);
+            }
+            sendPacket(pk, Lpvs::backward);
+            sendPacket(pk, Lpvs::forward);//special
+            pk->setEfailed(false);//special
+        }
+        else if(from == Lpvs::forward)
+        {
+            if (pk->getEfailed()){
+                sendPacket(pk, EAST);
+            }
+            if (pk->getWfailed()){
+                sendPacket(pk, WEST);
+            }
+            if (Lpvs::edge(pk) != this->myOrensIndex)
+            {
+                sendPacket(pk, Lpvs::backward);
+            }
+        }
+    }
+    else //If indexOnPlane == j
+    {
+        EV_DEBUG << "my index:" << myOrensIndex <<" it is j: " << pk->getJ() << endl;
+        if(pk->getTTL() <= 0)
+        {
+            EV_DEBUG << "TTL == 0" << endl;
+            getParentModule()->bubble("TTL = 0, DISCARDING");
+            return;
+        }
+        // Decrease TTL
+        pk->setTTL(pk->getTTL() - 1);
+        if(this->myPlane == config.minPlane){
+            pk->setWfailed(false);
         }
+        if(this->myPlane == config.maxPlane){
+            pk->setEfailed(false);
+        }
+        //set reached j == true
+        pk->setReachedJ(true);
+        EV_DEBUG << "received from:" << from << endl;
+        // If Received from up ISL :
+        if (from == Lpvs::forward)
+        {
+            sendPacket(pk, Lpvs::backward);
 
-        if (match_condition)
+            if(pk->getEfailed()){
+                sendPacket(pk, EAST);
+            }
+            if(pk->getEfailed()||pk->getWfailed()){
+                sendPacket(pk, Lpvs::forward);
+            }
+        }
+        else if (from == Lpvs::backward) // If Received from down ISL :
         {
-            int numBitsLeft = std::stoi(fields[3]);
-            int currentPkt = 1;
-            while (numBitsLeft > maxBitsperMsg)
+            EV_DEBUG << "Received from DownISL: " << from << endl;
+            if(this->isDirectionFailed(EAST))
+            {
+                EV_DEBUG << "Sending on UpISL because direction EAST is failed" << endl;
+                // set EFailed, send on downISL.
+                pk->setEfailed(true);
+            }
+            else
             {
-                std::string key = fields[0] + "," + fields[1] + "," + std::to_string(currentPkt);
-                this->activeTraffics[key] = false;
-                currentPkt++;
-                numBitsLeft -= maxBitsperMsg;
+                EV_DEBUG << "Sending on EastISL" << endl;
+                // send to east ISL
+                sendPacket(pk, EAST);
             }
-            std::string key = fields[0] + "," + fields[1] + "," + std::to_string(currentPkt);
-            this->activeTraffics[key] = false;
+            sendPacket(pk, Lpvs::forward);
+        }
+        else // not from up
+        {
+            EV_DEBUG << "Received from east ISL or received from downISL and Wfailed" << endl;
+            // clear Efailed
+            pk->setEfailed(false);
+            sendPacket(pk, Lpvs::forward);
+            sendPacket(pk, Lpvs::backward);
         }
     }
 }
 
+void App::getCSVdata()
+{
+    // the traffic records of this satellite, parsed once by the scenario store
+    traffic = &scenario->getTraffic(myAddress);
+    nextTraffic = 0;
+}
+
 void App::extractSatelliteTimes()
 {
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    std::string sat_times = "sheets/scenerio" + std::to_string(scenerio_num) + "_sat_times.csv";
-    std::ifstream file(sat_times);
-//    std::ifstream file("sheets/scenerio1_sat_times.csv"); // open the file for reading
-    std::string line; // variable to store each line of the file
-    std::vector<std::string> fields; // vector to store the fields of the current line
-
-    getline(file, line); // skip header
-
-    while (getline(file, line)) {
-        std::stringstream ss(line);
-        std::string status, satellite, time_sec;
-        getline(ss, status, ',');
-        getline(ss, satellite, ',');
-        getline(ss, time_sec);
-
-        int sat = stoi(satellite);
-        int time = stoi(time_sec);
-
-        if (status == "START") {
-            activeAddressesTimes[sat].first = time;
-        } else if (status == "STOP") {
-            activeAddressesTimes[sat].second = time;
-        }
-    }
-    file.close();
+    // START and STOP times of all the satellites, parsed once by the scenario store
+    activeAddressesTimes = &scenario->getSatelliteTimes();
 }
 
 void App::updateIsValNorth(int change) // CHANGED
 {
-    // get the data from CSV, and change color and icon
-//    if(change == 1){
-    getParentModule()->getDisplayString().setTagArg("i2",0,"status/up");
-    getParentModule()->getDisplayString().setTagArg("i2",1,"blue");
-    getParentModule()->getDisplayString().setTagArg("t",2,"blue");
-//    }
-//    else
-//    {
-//        getParentModule()->getDisplayString().setTagArg("i2",0,"status/down");
-//        getParentModule()->getDisplayString().setTagArg("i2",1,"red");
-//        getParentModule()->getDisplayString().setTagArg("t",2,"red");
-//    }
+    // get the data from CSV, the color and icon follow in refreshDisplay()
     this->is_val_north = 1;// change;
+    displayChanged = true;
 
 }
 
@@ -1080,7 +708,7 @@ void App::updateGUI(Packet* pk)
         cCanvas *canvas = getParentModule()->getParentModule()->getCanvas();
         cTextFigure *textFigure = check_and_cast<cTextFigure*>(canvas->getFigure("worstDelay"));
         double curr_worst_delay = (atof(&textFigure->getText()[27]));
-        EV << curr_worst_delay <<endl;
+        EV_DEBUG << curr_worst_delay <<endl;
         // did this packet was worse than before, if so update the canvas
         if (curr_worst_delay >= 0 && (curr_worst_delay < simTime().dbl() - pk_generation_time))
         {
@@ -1093,25 +721,56 @@ void App::updateGUI(Packet* pk)
 
 void App::changeActiveStatus(bool start)
 {
-    if(start)
+    // flip the flag, the icon follows in refreshDisplay()
+    isActive = start;
+    wasActive = wasActive || start;
+    displayChanged = true;
+}
+
+void App::refreshDisplay() const
+{
+    // only called by the GUI, so batch runs skip all of this; the state
+    // drawn here changes on the link and activation events only
+    if (!displayChanged)
+        return;
+    displayChanged = false;
+
+    // display my address
+    cDisplayString& nodeDispStr = getParentModule()->getDisplayString();
+    std::string disp = "(" + std::to_string(myAddress) + "), " + std::to_string(myPlane)+ "," + std::to_string(myOrensIndex);
+    nodeDispStr.setTagArg("t",0,disp.c_str());
+    nodeDispStr.setTagArg("t",1,"t");
+    nodeDispStr.setTagArg("i2",0,"status/up");
+    nodeDispStr.setTagArg("i2",1,"blue");
+    nodeDispStr.setTagArg("t",2,"blue");
+
+    if (isActive)
     {
         // I'm an active satellite, make me bigger and green
-        getParentModule()->getDisplayString().setTagArg("is",0,"small");
-        getParentModule()->getDisplayString().setTagArg("i",1,"#32CD32");
-        getParentModule()->getDisplayString().setTagArg("i",2,66);
-
-        // flig the flag
-        isActive = true;
+        nodeDispStr.setTagArg("is",0,"small");
+        nodeDispStr.setTagArg("i",1,"#32CD32");
+        nodeDispStr.setTagArg("i",2,66);
     }
-    else
+    else if (wasActive)
     {
-        // I'm not active satellite,
-        getParentModule()->getDisplayString().setTagArg("is",0,"vs");
-        getParentModule()->getDisplayString().setTagArg("i",1,"#BABDB6");
-        getParentModule()->getDisplayString().setTagArg("i",2,1);
+        // I'm not active satellite anymore
+        nodeDispStr.setTagArg("is",0,"vs");
+        nodeDispStr.setTagArg("i",1,"#BABDB6");
+        nodeDispStr.setTagArg("i",2,1);
+    }
 
-        // flig the flag
-        isActive = false;
+    // hide the dead ISLs, Up and Down connections are drawn gray
+    for (int dir = UP; dir <= WEST; dir++)
+    {
+        if (neighbors[dir].address == -1)
+            continue;
+        cGate *gate = getParentModule()->gate("port$o", neighbors[dir].gateIndex);
+        if (!neighbors[dir].connected)
+            gate->getDisplayString().parse("ls=,0,");
+        else if (dir == UP || dir == DOWN)
+            gate->getDisplayString().parse("ls=gray,0.5,d");
+        else
+            gate->getDisplayString().parse("ls=,1,");
     }
 }
 
@@ -1119,22 +778,30 @@ void App::getNeighbors()
 {
     // function that gets all the neighbors of the module
     // and save if the state of the connection and direction
+    for (int dir = 0; dir <= WEST; dir++)
+    {
+        neighbors[dir].address = -1;
+        neighbors[dir].gateIndex = -1;
+        neighbors[dir].queueGate = NULL;
+        neighbors[dir].index = -1;
+        neighbors[dir].connected = false;
+    }
     for (int i = 0; i < this->getParentModule()->gateSize("port$o"); i++)
     {
         cGate *gate = this->getParentModule()->gate("port$o", i);
         cModule *connectedModule = gate->getNextGate()->getOwnerModule();
         int neighborAdd = connectedModule->par("address").intValue();
         bool connected = true;
-        int neighborPlane = (neighborAdd)/100;
+        int neighborPlane = config.planeOf(neighborAdd);
         int direction;
         //EV << neighborPlane << "\n";
         if (myPlane == neighborPlane)
         {
-            if(myAddress%100 == getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue() && neighborAdd%100 == 1)
+            if(config.slotOf(myAddress) == config.numSatPerPlane && config.slotOf(neighborAdd) == 1)
             {
                 direction = UP;
             }
-            else if(neighborAdd%100 == getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue() && myAddress%100 == 1)
+            else if(config.slotOf(neighborAdd) == config.numSatPerPlane && config.slotOf(myAddress) == 1)
             {
                 direction = DOWN;
             }
@@ -1152,7 +819,7 @@ void App::getNeighbors()
         }
         else
         {
-            if ( myPlane == getParentModule()->getParentModule()->par("num_of_planes").intValue())
+            if ( myPlane == config.numPlanes)
             {
                 if ( neighborPlane == 1)
                 {
@@ -1163,7 +830,7 @@ void App::getNeighbors()
                     direction = WEST;
                 }
             }
-            else if ( neighborPlane == getParentModule()->getParentModule()->par("num_of_planes").intValue())
+            else if ( neighborPlane == config.numPlanes)
             {
                 if ( myPlane == 1)
                 {
@@ -1186,458 +853,128 @@ void App::getNeighbors()
                 }
             }
         }
-        neighbors.insert(std::make_pair(neighborAdd,std::make_pair(connected,direction)));
-    }
-    EV << "{ ";
-    for (auto it = neighbors.begin(); it != neighbors.end(); ++it) {
-        const auto& key = it->first;
-        const auto& value = it->second;
-        EV << key << ": (" << value.first << ", " << value.second << ") ";
-    }
-    EV << "}\n";
-}
-
-void App::getConnections()
-{
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    std::string connetions = "sheets/scenerio" + std::to_string(scenerio_num) + "_connections.csv";
-    std::ifstream file(connetions);
-    // get the connection to connectionsEvents that hold the next reconnection and disconnections of the module
-//    std::ifstream file("sheets/scenerio1_connections.csv");
-    std::string line;
-
-    // skip the first line of the file
-    getline(file, line);
-
-    while (std::getline(file, line))
-    {
-        std::istringstream iss(line);
-        std::vector<std::string> tokens;
-        std::string token;
-        while (std::getline(iss, token, ',')) {
-            tokens.push_back(token);
-        }
-
-        double start = std::stod(tokens[0]);
-        double stop = std::stod(tokens[1]);
-        int to = std::stoi(tokens[2]);
-        int from = std::stoi(tokens[3]);
-        int isAscending = std::stoi(tokens[4]);
-
-        if (to == myAddress)
-        {
-            EV<< "My Address: "<<myAddress<< " from " << from <<endl;
-            connectionsEvents.push_back(std::make_tuple(start, stop, from, isAscending));
-        }
-        if (from == myAddress)
+        if (this->neighborDirection(neighborAdd) != 0)
         {
-            EV<< "My Address: "<<myAddress<< " to " << to <<endl;
-            connectionsEvents.push_back(std::make_tuple(start, stop, to, isAscending));
+            continue; // already connected to this neighbor through another port
         }
-    }
-
-    // sort the connections by start time
-    std::sort(connectionsEvents.begin(), connectionsEvents.end());
-
-    for (const auto& event : connectionsEvents) {
-        EV << std::get<0>(event) << ", " << std::get<1>(event) << ", " << std::get<2>(event) << ", " << std::get<3>(event) << std::endl;
-    }
-
-}
-
-void App::disconnectWith(int neighborAddress)
-{
-    // update that this connection is now dead
-    neighbors[neighborAddress].first = false;
-    EV << "disconnected "<<myAddress << " with "<<neighborAddress<<endl;
-    // update GUI
-    for (int i = 0; i < this->getParentModule()->gateSize("port$o"); i++)
-    {
-        cGate *gate = this->getParentModule()->gate("port$o", i);
-        cModule *connectedModule = gate->getNextGate()->getOwnerModule();
-        if (connectedModule->par("address").intValue() == neighborAddress)
+        if (neighbors[direction].address != -1)
         {
-            cDisplayString& connDispStr = gate->getDisplayString();
-            connDispStr.parse("ls=,0,");
+            EV_WARN << "ignoring " << neighborAdd << ", " << neighbors[direction].address << " is already the neighbor in direction " << direction << endl;
+            continue;
         }
-    }
+        neighbors[direction].address = neighborAdd;
+        neighbors[direction].gateIndex = i;
+        neighbors[direction].queueGate = getParentModule()->getSubmodule("queue", i)->gate("directIn");
+        neighbors[direction].index = routingDatabase->getNodeIndex(neighborAdd);
+        neighbors[direction].connected = connected;
+    }
+    EV_DEBUG << "{ ";
+    for (int dir = UP; dir <= WEST; dir++) {
+        if (neighbors[dir].address != -1)
+            EV_DEBUG << neighbors[dir].address << ": (" << neighbors[dir].connected << ", " << dir << ") ";
+    }
+    EV_DEBUG << "}\n";
 }
 
-void App::reconnectWith(int neighborAddress)
+void App::getConnections()
 {
-    // update that this connection is now alive
-    neighbors[neighborAddress].first = true;
+    // get the connection to connectionsEvents that hold the next reconnection and disconnections of the module,
+    // already sorted by start time by the scenario store
+    connectionsEvents = &scenario->getConnections(myAddress);
+    nextConnection = 0;
 
-    // update GUI
-    EV << "connected "<< myAddress << " with " << neighborAddress<<endl ;
-    for (int i = 0; i < this->getParentModule()->gateSize("port$o"); i++)
-    {
-        cGate *gate = this->getParentModule()->gate("port$o", i);
-        cModule *connectedModule = gate->getNextGate()->getOwnerModule();
-        if (connectedModule->par("address").intValue() == neighborAddress)
-        {
-            cDisplayString& connDispStr = gate->getDisplayString();
-            connDispStr.parse("ls=,1,");
-        }
+    // the windows may overlap, so the disconnections are taken in their own order
+    disconnections.clear();
+    for (const auto& event : *connectionsEvents) {
+        disconnections.push_back(std::make_pair(std::get<1>(event), std::get<2>(event)));
     }
-}
-
-bool App::isNorth(int satAddress)
-{
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    std::string traffic_gen = "sheets/scenerio" + std::to_string(scenerio_num) + "_traffic_gen.csv";
-    std::ifstream file(traffic_gen);
-    // function that will return true if the given satellite address is moving north
-//    std::ifstream file("sheets/scenerio1_traffic_gen.csv"); // open the file for reading
-    std::string line; // variable to store each line of the file
-    std::vector<std::string> fields; // vector to store the fields of the current line
-
-    std::vector<std::vector<int>> satState;
-    int maxTime = -1;
-    int timestamp = -1;
-    bool mostRecent = false;
-
-    // skip the first line of the file
-    getline(file, line);
-
-    // loop through each line of the file
-    while (getline(file, line))
-    {
-        std::stringstream ss(line); // create a stringstream from the line
-        std::string field; // variable to store each field of the line
-        int field_count = 0; // variable to keep track of the current field number
-        bool match_condition = false; // variable to keep track of whether the 3rd field matches the condition
-
-        fields.clear(); // clear the vector of fields for the current line
+    std::stable_sort(disconnections.begin(), disconnections.end(),
+            [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first < b.first; });
+    nextDisconnection = 0;
 
-        // loop through each field of the line
-        while (getline(ss, field, ','))
-        {
-            field_count++; // increment the field count
-            if (field_count == 1)
-            {
-                // check if this is the 3rd field
-                if (std::stoi(field) == satAddress)
-                {
-                    match_condition = true;
-                }
-            }
-            fields.push_back(field); // store the field in the vector of fields for the current line
-        }
-        // get most recent value of is_val_north, that isn't bigger than the current time, and is of the given address
-        timestamp = std::stoi(fields[1]);
-        if(match_condition && timestamp <= simTime().dbl() && timestamp >= maxTime)
-        {
-            (fields[2] == "True") ? (mostRecent = true) : (mostRecent = false);
-        }
+    for (const auto& event : *connectionsEvents) {
+        EV_DEBUG << std::get<0>(event) << ", " << std::get<1>(event) << ", " << std::get<2>(event) << ", " << std::get<3>(event) << std::endl;
     }
-    return mostRecent;
+
 }
 
-std::vector<int> App::getASorMAS(bool giveAS)
+void App::scheduleNextConnection()
 {
-    std::vector<int> set;
-    for (auto it = activeAddressesTimes.begin(); it != activeAddressesTimes.end(); ++it) {
-        const auto& key = it->first;
-        const auto& value = it->second;
-        if(giveAS && this->isNorth(key) && simTime().dbl() >= value.first && simTime().dbl() < value.second)
-        {
-            set.push_back(key);
-        }
-        if(!giveAS && !(this->isNorth(key)) && simTime().dbl() >= value.first && simTime().dbl() < value.second)   //we want MAS, so check if south
-        {
-            set.push_back(key);
-        }
-    }
-    if(giveAS)
-    {
-        EV << "AS: ";
-    }
-    else
-    {
-        EV << "MAS: ";
-    }
-    for (auto & sat : set) {
-        EV << sat << " ";
-    }
-    EV << endl;
-    /*******************
-    // get AS or MAS depending on giveAS
-    std::vector<int> set;
-    for (auto & activeSat : activeAddresses) {
-        if(giveAS && this->isNorth(activeSat)) // we want AS, so check if north
-        {
-            set.push_back(activeSat);
-        }
-        if(!giveAS && !(this->isNorth(activeSat)))   //we want MAS, so check if south
-        {
-            set.push_back(activeSat);
-        }
-    }*/
-    return set;
+    // schedule the earliest connection that didn't happen yet; the ones that
+    // start at the same time follow each other at that time
+    if (nextConnection >= connectionsEvents->size())
+        return;
+    const ConnectionEvent& next = (*connectionsEvents)[nextConnection];
+    controlConnect->setTime(std::get<0>(next));
+    controlConnect->setAddress(std::get<2>(next));
+    controlConnect->setIsAsending(std::get<3>(next));
+    scheduleAt(controlConnect->getTime(), controlConnect);
 }
 
-std::vector<int> App::getAPorMAP(bool giveAP)
+void App::scheduleNextDisconnection()
 {
-    // get AP or MAP depending of giveAP
-    // from AS and MAP
-    std::vector<int> set = this->getASorMAS(giveAP);
-    std::vector<int> planeSet;
-
-    // get only the planes for the set
-    for (auto & sat : set) {
-        planeSet.push_back((sat) / 100);
-    }
-    // remove repeated planes
-    sort( planeSet.begin(), planeSet.end() );
-    planeSet.erase( unique( planeSet.begin(), planeSet.end() ), planeSet.end() );
-    return planeSet;
+    // schedule the earliest disconnection that didn't happen yet; windows
+    // without an end (open at the end of the scenario) are never closed
+    if (nextDisconnection >= disconnections.size() || std::isinf(disconnections[nextDisconnection].first))
+        return;
+    const std::pair<double, int>& next = disconnections[nextDisconnection];
+    controlDisconnect->setTime(next.first);
+    controlDisconnect->setAddress(next.second);
+    scheduleAt(controlDisconnect->getTime(), controlDisconnect);
 }
 
-std::vector<int> App::getAPS()
+void App::disconnectWith(int neighborAddress)
 {
-    std::vector<int> AP = this->getAPorMAP(true);
-    std::vector<int> MAP = this->getAPorMAP(false);
-    std::vector<int> APS = AP;
-
-    // append the values from MAP to the end of the APS vector
-    APS.insert(APS.end(), MAP.begin(), MAP.end());
-
-    // sort the vector to bring duplicate values together
-    std::sort(APS.begin(), APS.end());
-
-    // remove duplicates
-    auto last = std::unique(APS.begin(), APS.end());
-    APS.erase(last, APS.end());
-    EV << "APS: ";
-    for (auto & aps : APS) {
-        EV << aps << " ";
+    // update that this connection is now dead
+    int dir = this->neighborDirection(neighborAddress);
+    EV_DETAIL << "disconnected "<<myAddress << " with "<<neighborAddress<<endl;
+    if (dir == 0)
+    {
+        return; // not a neighbor of this module
     }
-    EV<< endl;
-    return APS;
+    neighbors[dir].connected = false;
+    routingDatabase->setLinkState(myAddress, neighborAddress, false);
+    displayChanged = true;
 }
 
-std::vector<int> App::calculateb1b2()
+void App::reconnectWith(int neighborAddress)
 {
-    // calclualte b1 and b2 from the algo
-    // get AP and MAPs
-    std::vector<int> AP = this->getAPorMAP(true);
-    EV << "AP: ";
-    for (auto & ap : AP) {
-        EV << ap << " ";
-    }
-    EV << endl;
-    std::vector<int> MAP = this->getAPorMAP(false);
-    EV << "MAP: ";
-    for (auto & map : MAP) {
-        EV << map << " ";
-    }
-    EV << endl;
-
-    std::vector<int> APS = this->getAPS();
-    int max_dist = -1;
-    int number_of_planes = getParentModule()->getParentModule()->par("num_of_planes");;
-    int b1 = -1;
-    int b2 = -1;
-    sort(APS.begin(),APS.end());
-    // find the farthest planes
-    for (int i=0;i<APS.size()-1;i++)
-    {
-        int currentGap= APS[i+1] - APS[i];
-        if(currentGap>max_dist)
-        {
-            max_dist=currentGap;
-            b1=APS[i];
-            b2=APS[i+1];
-        }
-    }
-    // Check if there is a gap between the last and first numbers in the cycle
-    int gapBetweenEndAndStart = APS.front() + (number_of_planes - APS.back());
-    if (gapBetweenEndAndStart > max_dist) {
-        max_dist = gapBetweenEndAndStart;
-        b1 = APS.back();
-        b2 = APS.front();
-    }
-    /*
-    int min_dist = getParentModule()->getParentModule()->par("num_of_planes"); // initialize to maximum possible distance
-    int number_of_panes = min_dist;
-    int b1 = -1;
-    int b2 = -1;
+    // update that this connection is now alive
+    int dir = this->neighborDirection(neighborAddress);
 
-    // find the closest edges
-    for (auto & ap : AP)
+    EV_DETAIL << "connected "<< myAddress << " with " << neighborAddress<<endl ;
+    if (dir == 0)
     {
-        for (auto & map : MAP)
-        {
-            int dist = std::min(abs(ap-map), number_of_panes-abs(ap-map));  // minimum distance between the two planes
-            if (dist < min_dist)
-            { // update minimum distance and closest edge elements if a smaller distance is found
-                min_dist = dist;
-                b1 = ap;
-                b2 = map;
-            }
-        }
+        return; // not a neighbor of this module
     }
-    */
-    // return findings
-    std::vector<int> edges;
-    edges.push_back(b1);edges.push_back(b2);
-    EV << "b1: " << b1 << ", b2; " << b2 << endl;
-    return edges;
+    neighbors[dir].connected = true;
+    routingDatabase->setLinkState(myAddress, neighborAddress, true);
+    displayChanged = true;
 }
 
 int App::convertToOrensIndex(int address)
 {
     // given an address calculate the respondings orens index
-    //return ((address%100) - 3 + getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue())%getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue();
-
-    while(address>200)
-    {
-        address -= 97;
-    }
-    int canidate = (address % 100);
-    if (canidate <= getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue())
-    {
-        return canidate;
-    }
-    else
-    {
-        return (canidate % (getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue() + 1)) + 1;
-    }
+    return membership->convertToOrensIndex(address);
 }
 
 void App::getOrensMapping()
 {
     // saves all the mapping of orens index to the regular indexes
-    for(int plane=1; plane <= getParentModule()->getParentModule()->par("num_of_planes").intValue(); plane++)
-    {
-        for(int index=1; index <= getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue(); index++)
-        {
-            orensMapping.push_back(std::make_tuple( this->convertToOrensIndex(plane*100 + index) , plane*100 +index ));
-        }
-    }
-}
-
-std::vector<int> App::calculateVU()
-{
-    // return VU (west and eastmost) indexes for algorithm in oren's notation
-    std::vector <int>  orens;
-    for (auto it = activeAddressesTimes.begin(); it != activeAddressesTimes.end(); ++it) {
-        const auto& key = it->first;
-        const auto& value = it->second;
-        if(simTime().dbl() >= value.first && simTime().dbl() < value.second)
-        {
-            orens.push_back(this->convertToOrensIndex(key));
-        }
-    }
-    /*
-    for (auto& address: activeAddresses)
+    for(int plane=1; plane <= config.numPlanes; plane++)
     {
-        orens.push_back(this->convertToOrensIndex(address));
-    }
-    */
-    sort( orens.begin(), orens.end() );
-    orens.erase( unique( orens.begin(), orens.end() ), orens.end() );
-
-    int max_dist = -1; // initialize to minimum possible distance
-    int num_of_sat_per_plane = getParentModule()->getParentModule()->par("num_of_sat_per_plane");
-    int c1 = -1;
-    int c2 = -1;
-
-    // Iterate through the sorted numbers and find the biggest gap
-    for (int i = 0; i < orens.size() - 1; i++) {
-        int currentGap = orens[i + 1] - orens[i];
-        if (currentGap > max_dist) {
-            max_dist = currentGap;
-            c1 = orens[i];
-            c2 = orens[i + 1];
-        }
-    }
-
-    // Check if there is a gap between the last and first numbers in the cycle
-    int gapBetweenEndAndStart = orens.front() + (num_of_sat_per_plane - orens.back());
-    if (gapBetweenEndAndStart > max_dist) {
-        max_dist = gapBetweenEndAndStart;
-        c1 = orens.back();
-        c2 = orens.front();
-    }
-
-    // we have the edges, now which one is or west
-    // c1 and c2 can be either east,west or west,east
-    // lets assume c1<c2
-    if (c1>c2)
-    {
-        int temp = c1;
-        c1 = c2;
-        c2 = temp;
-    }
-
-    // check if each address is between c1 and c2, i.e ...c1...address...c2..
-    bool in_between = false;
-    for (auto & oren : orens)
-    {
-        if (c1 < oren && oren < c2)
+        for(int index=1; index <= config.numSatPerPlane; index++)
         {
-            in_between = true;
-            break;
+            orensMapping.push_back(std::make_tuple( this->convertToOrensIndex(config.addressOf(plane, index)) , config.addressOf(plane, index) ));
         }
     }
-
-    std::vector<int> vu;
-    if (in_between)
-    {
-        // then c1 is west and c2 is east
-        vu.push_back(c1);
-        vu.push_back(c2);
-    }
-    else
-    {
-        // then c1 is east and c2 is west
-        vu.push_back(c2);
-        vu.push_back(c1);
-    }
-    EV << "v: " << vu[0] << ", u; " << vu[1] << endl;
-    return vu;
 }
 
 
 bool App::doesHaveInterPlane(int address)
 {
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-    // check if the address have inter plane available now
-    std::string connections = "sheets/scenerio" + std::to_string(scenerio_num) + "_connections.csv";
-    std::ifstream file(connections);
-//    std::ifstream file("sheets/scenerio1_connections.csv");
-    std::string line;
-    bool haveInter = false;
-
-    // skip the first line of the file
-    getline(file, line);
-
-    while (std::getline(file, line))
-    {
-        std::istringstream iss(line);
-        std::vector<std::string> tokens;
-        std::string token;
-        while (std::getline(iss, token, ',')) {
-            tokens.push_back(token);
-        }
-
-        double start = std::stod(tokens[0]);
-        double stop = std::stod(tokens[1]);
-        int to = std::stoi(tokens[2]);
-        int from = std::stoi(tokens[3]);
-
-        if ((to == address || from == address))
-        {
-            if ((start <= simTime().dbl()) &&  (stop > simTime().dbl()))
-            {
-                haveInter = true;
-            }
-
-        }
-    }
-    return haveInter;
+    // check if the address have inter plane available now, i.e. one of its connection windows is open
+    return scenario->hasLiveConnection(address, simTime().dbl());
 }
 
 bool App::doesOrenIndexHaveInterPlane(int orenIndex)
@@ -1654,11 +991,11 @@ bool App::doesOrenIndexHaveInterPlane(int orenIndex)
             }
             else
             {
-                EV << "orens index : ";
-                EV << std::get<0>(tuple) << endl;
-                EV << "address : ";
-                EV << std::get<1>(tuple) << endl;
-                EV << this->doesHaveInterPlane(std::get<1>(tuple)) << endl;
+                EV_DEBUG << "orens index : ";
+                EV_DEBUG << std::get<0>(tuple) << endl;
+                EV_DEBUG << "address : ";
+                EV_DEBUG << std::get<1>(tuple) << endl;
+                EV_DEBUG << this->doesHaveInterPlane(std::get<1>(tuple)) << endl;
                 haveInterPlane = false;
                 break;
             }
@@ -1668,60 +1005,35 @@ bool App::doesOrenIndexHaveInterPlane(int orenIndex)
     return haveInterPlane;
 }
 
-int App::calculateJ(int vu)
-{
-    bool goLeft = getParentModule()->getParentModule()->par("goLeft");;
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-        if (scenerio_num == 2){
-            int minPlane = 1;
-        }
-    // given u or v in orens notation, finds the corresponding j in orens notation
-    if(!goLeft){
-        int jindex = (((int) vu / 2 + 1) * 2) % (getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue());
-            EV << "j: "  << jindex << endl;
-            return jindex;
-    }
-    else if(goLeft)
-    {
-        int jindex = (((int) vu - 1)) % (getParentModule()->getParentModule()->par("num_of_sat_per_plane").intValue());
-                            EV << "j: "  << jindex << endl;
-                            return jindex;
-    }
-    return true;
-}
-
-
-Packet* App::generateNewPacket(int collectedData, int numPktperMsg) //new
+Packet* App::generateNewPacket(int collectedData, int numPktperMsg, int numFragments) //new
 {
-    bool goLeft = getParentModule()->getParentModule()->par("goLeft");;
-    int scenerio_num = getParentModule()->getParentModule()->par("scenerio_num");;
-        if (scenerio_num == 2){
-            int minPlane = 1;
-        }
     char pkname[40];
     sprintf(pkname,"pk-%d", myAddress);
     Packet *pk = new Packet(pkname);
     pk->setBitLength(collectedData);
     pk->setSrcAddr(myAddress);
+    pk->setSrcIndex(myIndex);
     pk->setIntermediateSrcAddr(myAddress);
 
     pk->setTTL(myTTL);
     pk->setReachedJ(false);
-    pk->setB1(this->calculateb1b2()[0]);
-    pk->setB2(this->calculateb1b2()[1]);
-    pk->setV(this->calculateVU()[0]);
-    pk->setU(this->calculateVU()[1]);
-    if(!goLeft)
-    {
-       pk->setJ(this->calculateJ(pk->getU()));
-    }
-    else if(goLeft)
-        {
-           pk->setJ(this->calculateJ(pk->getV()));
-        }
+    const SwarmGeometry& swarm = membership->getGeometry();
+    pk->setB1(swarm.b1);
+    pk->setB2(swarm.b2);
+    pk->setV(swarm.v);
+    pk->setU(swarm.u);
+    pk->setJ(swarm.j);
 
 
     pk->setnumPktperMsg(numPktperMsg);
+    // a fragment train takes consecutive sequence numbers, one per fragment
+    pk->setSeqNum(nextSeqNum);
+    pk->setNumFragments(numFragments);
+    pk->setFragmentBits(numFragments > 1 ? config.maxBitsPerMsg : collectedData);
+    for (int i = 0; i < numFragments; i++)
+    {
+        syncCollector->fragmentGenerated(myAddress, nextSeqNum++);
+    }
 
     pk->setWfailed(true);
     pk->setEfailed(true);
@@ -1732,18 +1044,14 @@ Packet* App::generateNewPacket(int collectedData, int numPktperMsg) //new
 int App::getISL(int to)
 {
     int search_result = -1;
-    for (const auto& neighbor : neighbors)
+    if (to >= UP && to <= WEST && neighbors[to].connected)
     {
-        if (neighbor.second.first && neighbor.second.second == to)
-        {
-            search_result = neighbor.first;
-            break;
-        }
+        search_result = neighbors[to].address;
     }
     if (search_result == -1)
     {
         EV << "{ ";
-        for (auto it = activeAddressesTimes.begin(); it != activeAddressesTimes.end(); ++it) {
+        for (auto it = activeAddressesTimes->begin(); it != activeAddressesTimes->end(); ++it) {
             const auto& key = it->first;
             const auto& value = it->second;
             EV << key << ": (" << value.first << ", " << value.second << ") ";
@@ -1758,41 +1066,60 @@ int App::getISL(int to)
     }
 }
 
-int App::neighborDirection(int neighborAddr)
+bool App::isNewTraffic(int srcIndex, int seqNum)
 {
-    // from neighbor address, return the direction he is relative to the node
-    return neighbors[neighborAddr].second;
+    // check if I already saw this fragment, and remember it
+    auto it = seenTraffics.find(srcIndex);
+    if (it == seenTraffics.end())
+    {
+        it = seenTraffics.emplace(srcIndex, SequenceWindow(dedupWindow)).first;
+    }
+    return it->second.insert(seqNum);
 }
 
-bool App::isDirectionFailed(int dir)
+int App::neighborDirection(int neighborAddr)
 {
-    // check if the give direction is down, if it is, returns true
-    for (const auto& item : neighbors)
+    // from neighbor address, return the direction he is relative to the node, 0 if not a neighbor
+    for (int dir = UP; dir <= WEST; dir++)
     {
-        if (item.second.second == dir)
+        if (neighbors[dir].address == neighborAddr && neighborAddr != -1)
         {
-            return !item.second.first;
+            return dir;
         }
     }
-    return false;
+    return 0;
+}
+
+bool App::isDirectionFailed(int dir)
+{
+    // check if the give direction is down, if it is, returns true
+    return neighbors[dir].address != -1 && !neighbors[dir].connected;
 }
 
 void App::writeRecvCSV(double time, int sender, double latency, int numpckPerMsg,int hopCount,int bitLength)
 {
-    std::string fileName = "outfiles/recv" + std::to_string(myAddress) + ".csv";
-    std::ofstream outFile(fileName, std::ios::app);
-    if (!outFile.is_open())
+    if (resultWriter->writesEventLog())
+    {
+        EventRecord record = {time, latency, EVENT_RECEIVED, sender, myAddress, numpckPerMsg, hopCount, bitLength};
+        resultWriter->logEvent(record);
+    }
+    if (!resultWriter->writesTextFiles())
     {
-        throw cRuntimeError("Error opening file in Recv!");
+        return;
     }
-    outFile << time << "," << sender << "," << latency << "," << numpckPerMsg <<  "," << hopCount << "," <<bitLength <<"\n";
-    outFile.close();
+    if (recvStream == -1)
+    {
+        recvStream = resultWriter->getStream("outfiles/recv" + std::to_string(myAddress) + ".csv");
+    }
+    resultLine.str("");
+    resultLine << time << "," << sender << "," << latency << "," << numpckPerMsg <<  "," << hopCount << "," <<bitLength <<"\n";
+    resultWriter->append(recvStream, resultLine.str());
 }
 
 std::string App::getActiveAddressesAsString()
 {
     std::string activeAddresses;
-    for (const auto& entry : activeAddressesTimes)
+    for (const auto& entry : *activeAddressesTimes)
     {
         int startTime = entry.second.first;
         int endTime = entry.second.second;
@@ -1811,23 +1138,42 @@ std::string App::getActiveAddressesAsString()
 
 void App::writeSentCSV()
 {
+    if (resultWriter->writesEventLog())
+    {
+        EventRecord record = {simTime().dbl(), 0, EVENT_SENT, myAddress, -1, 0, 0, 0};
+        resultWriter->logEvent(record);
+    }
+    if (!resultWriter->writesTextFiles())
+    {
+        return;
+    }
     std::string activeAddresses = this->getActiveAddressesAsString();
-    std::string fileName = "outfiles/sent" + std::to_string(myAddress) + ".csv";
-    std::ofstream outFile(fileName, std::ios::app);
-    if (!outFile.is_open())
+    if (sentStream == -1)
     {
-        throw cRuntimeError("Error opening file in Sent!");
+        sentStream = resultWriter->getStream("outfiles/sent" + std::to_string(myAddress) + ".csv");
     }
-    outFile << simTime().dbl() << "," << activeAddresses << "\n";
-    outFile.close();
+    resultLine.str("");
+    resultLine << simTime().dbl() << "," << activeAddresses << "\n";
+    resultWriter->append(sentStream, resultLine.str());
 }
 
 void App::sendPacket(Packet *pk, int direction)
 {
     if (!this->isDirectionFailed(direction)) {
         pk->setDestAddr(this->getISL(direction));
+        pk->setDestIndex(neighbors[direction].index);
         pk->setIntermediateSrcAddr(this->myAddress);
-        send(pk->dup(),"out");
+        if (directForwarding)
+        {
+            // the destination is always the neighbor, so skip the Routing lookup
+            Packet *copy = pk->dup();
+            copy->setHopCount(copy->getHopCount()+1);
+            sendDirect(copy, neighbors[direction].queueGate);
+        }
+        else
+        {
+            send(pk->dup(),"out");
+        }
         if (direction == EAST){
             pk->setEfailed(false);
         }
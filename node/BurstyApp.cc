@@ -130,7 +130,7 @@ void BurstyApp::processTimer(cMessage *msg)
             scheduleAt(simTime() + d, startStopBurst);
 
             // display message, restore normal icon color
-            EV << "sleeping for " << d << "s\n";
+            EV_DEBUG << "sleeping for " << d << "s\n";
             bubble("burst ended, sleeping");
             getDisplayString().setTagArg("i",1,"");
             break;
@@ -141,7 +141,7 @@ void BurstyApp::processTimer(cMessage *msg)
             scheduleAt(simTime() + d, startStopBurst);
 
             // display message, turn icon yellow
-            EV << "starting burst of duration " << d << "s\n";
+            EV_DEBUG << "starting burst of duration " << d << "s\n";
             bubble("burst started");
             getDisplayString().setTagArg("i",1,"yellow");
 
@@ -154,7 +154,7 @@ void BurstyApp::processTimer(cMessage *msg)
         case FSM_Enter(ACTIVE):
             // schedule next sending
             d = sendIATime->doubleValue();
-            EV << "next sending in " << d << "s\n";
+            EV_DEBUG << "next sending in " << d << "s\n";
             scheduleAt(simTime() + d, sendMessage);
             break;
 
@@ -188,7 +188,7 @@ void BurstyApp::generatePacket()
 
     char pkname[40];
     sprintf(pkname,"pk-%d-to-%d-#%d", myAddress, destAddress, pkCounter++);
-    EV << "generating packet " << pkname << endl;
+    EV_DEBUG << "generating packet " << pkname << endl;
 
     Packet *pk = new Packet(pkname);
     pk->setByteLength(packetLengthBytes->longValue());
@@ -200,7 +200,7 @@ void BurstyApp::generatePacket()
 void BurstyApp::processPacket(Packet *pk)
 {
     // update statistics and delete message
-    EV << "received packet " << pk->getName() << " after " << pk->getHopCount() << "hops" << endl;
+    EV_DEBUG << "received packet " << pk->getName() << " after " << pk->getHopCount() << "hops" << endl;
     emit(endToEndDelaySignal, simTime() - pk->getCreationTime());
     emit(hopCountSignal, pk->getHopCount());
     emit(sourceAddressSignal, pk->getSrcAddr());
@@ -0,0 +1,39 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <cmath>
+#include "ConstellationConfig.h"
+using namespace omnetpp;
+
+const int ConstellationConfig::PLANE_SHIFT;
+
+ConstellationConfig ConstellationConfig::fromNetwork(cModule *network)
+{
+    ConstellationConfig config;
+    config.numPlanes = network->par("num_of_planes");
+    config.numSatPerPlane = network->par("num_of_sat_per_plane");
+    config.addressBase = network->par("addressBase");
+    if (config.numSatPerPlane >= config.addressBase)
+        throw cRuntimeError("num_of_sat_per_plane=%d doesn't fit into the addresses, addressBase must be larger", config.numSatPerPlane);
+    config.goLeft = network->par("goLeft");
+    config.maxBitsPerMsg = network->par("maxBitsperMsg");
+    config.scenarioNum = network->par("scenerio_num");
+
+    // the per-scenario edge planes (minPlane 1 for scenario 2, planes 1..3 for scenario 3)
+    // used to be assigned to shadowing locals and never took effect, so all
+    // the scenarios run with planes 3..5; kept that way to not change results
+    config.minPlane = 3;
+    config.maxPlane = 5;
+
+    config.altitude = network->par("orbitAltitude").doubleValueInUnit("km");
+    config.inclination = network->par("orbitInclination").doubleValueInUnit("deg") * M_PI / 180;
+    config.raanSpread = network->par("raanSpread").doubleValueInUnit("deg") * M_PI / 180;
+    config.planePhasing = network->par("planePhasing").doubleValue();
+    return config;
+}
@@ -0,0 +1,57 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __CONSTELLATIONCONFIG_H
+#define __CONSTELLATIONCONFIG_H
+
+#include <omnetpp.h>
+
+/**
+ * The constellation and scenario parameters of the network, resolved once
+ * at initialization so the per-packet code reads plain fields instead of
+ * looking the NED parameters up by name.
+ *
+ * It also knows the address scheme: a satellite address is the pair
+ * (plane, slot) packed as plane * addressBase + slot, with planes counted
+ * from 1 (plus inter_plane_bias) and slots from 1 to numSatPerPlane. The
+ * scenario sheets and the packets use the packed form; everything that
+ * needs the plane or the slot goes through planeOf()/slotOf().
+ */
+struct ConstellationConfig
+{
+    int numPlanes;
+    int numSatPerPlane;
+    int addressBase;    // plane multiplier of the addresses, larger than numSatPerPlane
+    bool goLeft;        // LPVS direction, see LpvsDirection in App
+    int maxBitsPerMsg;  // larger traffic records are split into fragments
+    int scenarioNum;
+    int minPlane;       // the westmost and eastmost planes of the proxy routing
+    int maxPlane;
+
+    // the orbits, see OrbitPropagator
+    double altitude;    // km
+    double inclination; // rad
+    double raanSpread;  // rad, over all the planes
+    double planePhasing; // slots a plane is ahead of the previous one
+
+    // the slots every plane is shifted by against the previous one, see the node positions in NetLEO
+    static const int PLANE_SHIFT = 3;
+
+    int planeOf(int address) const {return address / addressBase;}
+    int slotOf(int address) const {return address % addressBase;}
+    int addressOf(int plane, int slot) const {return plane * addressBase + slot;}
+
+    // oren's index of an address: its slot shifted back to the first plane, 1..numSatPerPlane
+    int orensIndexOf(int address) const {return (slotOf(address) + PLANE_SHIFT * (planeOf(address) - 1) - 1) % numSatPerPlane + 1;}
+
+    // read the parameters of the given network module
+    static ConstellationConfig fromNetwork(omnetpp::cModule *network);
+};
+
+#endif
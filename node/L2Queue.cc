@@ -20,6 +20,7 @@ class L2Queue : public cSimpleModule
 {
   private:
     long frameCapacity;
+    cGate *appGate; // directIn gate of the App, NULL unless forwarding directly
 
     cQueue queue;
     cMessage *endTransmissionEvent;
@@ -41,7 +42,7 @@ class L2Queue : public cSimpleModule
 
     virtual void startTransmitting(cMessage *msg);
 
-    virtual void displayStatus(bool isBusy);
+    virtual void refreshDisplay() const override;
 };
 
 Define_Module(L2Queue);
@@ -49,6 +50,7 @@ Define_Module(L2Queue);
 L2Queue::L2Queue()
 {
     endTransmissionEvent = NULL;
+    appGate = NULL;
 }
 
 L2Queue::~L2Queue()
@@ -62,6 +64,8 @@ void L2Queue::initialize()
     endTransmissionEvent = new cMessage("endTxEvent");
 
     frameCapacity = par("frameCapacity");
+    if (par("directForwarding").boolValue())
+        appGate = getParentModule()->getSubmodule("app")->gate("directIn");
 
     qlenSignal = registerSignal("qlen");
     busySignal = registerSignal("busy");
@@ -76,8 +80,6 @@ void L2Queue::initialize()
 
 void L2Queue::startTransmitting(cMessage *msg)
 {
-    displayStatus(true);
-
     //EV << "Starting transmission of " << msg << endl;
     int64_t numBytes = check_and_cast<cPacket *>(msg)->getByteLength();
     send(msg, "line$o");
@@ -95,7 +97,6 @@ void L2Queue::handleMessage(cMessage *msg)
     {
         // Transmission finished, we can start next one.
         //EV << "Transmission finished.\n";
-        displayStatus(false);
         if (queue.empty())
         {
             emit(busySignal, 0);
@@ -112,7 +113,10 @@ void L2Queue::handleMessage(cMessage *msg)
     {
         // pass up
         emit(rxBytesSignal, (long)check_and_cast<cPacket *>(msg)->getByteLength());
-        send(msg,"out");
+        if (appGate)
+            sendDirect(msg, appGate);
+        else
+            send(msg,"out");
     }
     else // arrived on gate "in"
     {
@@ -144,8 +148,10 @@ void L2Queue::handleMessage(cMessage *msg)
     }
 }
 
-void L2Queue::displayStatus(bool isBusy)
+void L2Queue::refreshDisplay() const
 {
+    // only called by the GUI, batch runs skip it
+    bool isBusy = endTransmissionEvent->isScheduled();
     getDisplayString().setTagArg("t",0, isBusy ? "transmitting" : "idle");
     getDisplayString().setTagArg("i",1, isBusy ? (queue.length()>=3 ? "red" : "yellow") : "");
 }
@@ -0,0 +1,54 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <algorithm>
+#include "LinkIndex.h"
+
+
+void LinkIndex::build(const std::vector<LinkWindow>& rows)
+{
+    std::vector<LinkWindow> windows = rows;
+    std::stable_sort(windows.begin(), windows.end(),
+            [](const LinkWindow& a, const LinkWindow& b) { return a.start < b.start; });
+
+    // union of the windows of every satellite, as disjoint [start, stop) intervals
+    coverageBySat.clear();
+    for (const auto& window : windows)
+    {
+        if (window.stop <= window.start)
+            continue;
+        int ends[2] = {window.to, window.from};
+        for (int i = 0; i < (window.to == window.from ? 1 : 2); i++)
+        {
+            // windows come sorted by start, so only the last interval can overlap
+            std::vector<std::pair<double, double>>& coverage = coverageBySat[ends[i]];
+            if (!coverage.empty() && window.start <= coverage.back().second)
+            {
+                coverage.back().second = std::max(coverage.back().second, window.stop);
+            }
+            else
+            {
+                coverage.push_back(std::make_pair(window.start, window.stop));
+            }
+        }
+    }
+}
+
+bool LinkIndex::isLive(int address, double time) const
+{
+    auto it = coverageBySat.find(address);
+    if (it == coverageBySat.end())
+        return false;
+
+    // the last interval starting at or before the given time
+    const std::vector<std::pair<double, double>>& coverage = it->second;
+    auto next = std::upper_bound(coverage.begin(), coverage.end(), time,
+            [](double t, const std::pair<double, double>& interval) { return t < interval.first; });
+    return next != coverage.begin() && time < (next - 1)->second;
+}
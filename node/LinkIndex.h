@@ -0,0 +1,44 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __LINKINDEX_H
+#define __LINKINDEX_H
+
+#include <vector>
+#include <unordered_map>
+
+// one row of scenerioN_connections.csv: the ISL between to and from is up in [start, stop)
+struct LinkWindow
+{
+    double start;
+    double stop;
+    int to;
+    int from;
+    int isAscending;
+};
+
+/**
+ * Static index over the ISL windows of a scenario, built once.
+ *
+ * Every satellite gets the union of its windows as disjoint sorted
+ * intervals, so "does X have a live link at t" is a single binary search.
+ */
+class LinkIndex
+{
+  private:
+    std::unordered_map<int, std::vector<std::pair<double, double>>> coverageBySat;
+
+  public:
+    void build(const std::vector<LinkWindow>& rows);
+
+    // true if any window of the satellite has start <= time < stop
+    bool isLive(int address, double time) const;
+};
+
+#endif
@@ -0,0 +1,95 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <cmath>
+#include "OrbitPropagator.h"
+
+const double OrbitPropagator::EARTH_RADIUS = 6371.0;
+const double OrbitPropagator::EARTH_MU = 398600.4418;
+
+
+OrbitPropagator::OrbitPropagator(const ConstellationConfig& config)
+    : config(config)
+{
+    radius = EARTH_RADIUS + config.altitude;
+    meanMotion = sqrt(EARTH_MU / (radius * radius * radius));
+    cosInclination = cos(config.inclination);
+    sinInclination = sin(config.inclination);
+    raanSpacing = config.raanSpread / config.numPlanes;
+    slotSpacing = 2 * M_PI / config.numSatPerPlane;
+    planePhasing = config.planePhasing * slotSpacing;
+}
+
+int OrbitPropagator::addSatellite(int address)
+{
+    int plane = config.planeOf(address);
+    double raan = plane * raanSpacing;
+    double phase = (config.slotOf(address) - 1) * slotSpacing + plane * planePhasing;
+    planes.push_back(plane);
+    cosRaan.push_back(cos(raan));
+    sinRaan.push_back(sin(raan));
+    cosPhase.push_back(cos(phase));
+    sinPhase.push_back(sin(phase));
+
+    x.push_back(0);
+    y.push_back(0);
+    z.push_back(0);
+    cosU.push_back(0);
+    return planes.size() - 1;
+}
+
+double OrbitPropagator::getPeriod() const
+{
+    return 2 * M_PI / meanMotion;
+}
+
+void OrbitPropagator::propagate(double time)
+{
+    // u = phase + n*t for every satellite, by the angle sum formulas
+    double cosM = cos(meanMotion * time);
+    double sinM = sin(meanMotion * time);
+
+    size_t n = planes.size();
+    const double *cr = cosRaan.data();
+    const double *sr = sinRaan.data();
+    const double *cp = cosPhase.data();
+    const double *sp = sinPhase.data();
+    double *px = x.data();
+    double *py = y.data();
+    double *pz = z.data();
+    double *pu = cosU.data();
+    for (size_t i = 0; i < n; i++)
+    {
+        double cu = cp[i] * cosM - sp[i] * sinM;
+        double su = sp[i] * cosM + cp[i] * sinM;
+        double suCosI = su * cosInclination;
+        px[i] = radius * (cr[i] * cu - sr[i] * suCosI);
+        py[i] = radius * (sr[i] * cu + cr[i] * suCosI);
+        pz[i] = radius * su * sinInclination;
+        pu[i] = cu;
+    }
+}
+
+double OrbitPropagator::getDistance(int a, int b) const
+{
+    double dx = x[a] - x[b];
+    double dy = y[a] - y[b];
+    double dz = z[a] - z[b];
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+double OrbitPropagator::getGrazingAltitude(int a, int b) const
+{
+    // both ends are at the orbit radius, so the closest point of the chord
+    // to the Earth's center is its midpoint
+    double mx = (x[a] + x[b]) / 2;
+    double my = (y[a] + y[b]) / 2;
+    double mz = (z[a] + z[b]) / 2;
+    return sqrt(mx * mx + my * my + mz * mz) - EARTH_RADIUS;
+}
@@ -0,0 +1,83 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __ORBITPROPAGATOR_H
+#define __ORBITPROPAGATOR_H
+
+#include <cstddef>
+#include <vector>
+#include "ConstellationConfig.h"
+
+/**
+ * Keplerian propagator of the satellites of a constellation on circular
+ * orbits of a common altitude and inclination, given by the orbit
+ * parameters of the network (see ConstellationConfig).
+ *
+ * A satellite is placed by the (plane, slot) of its address: its orbital
+ * plane has RAAN plane * raanSpread / numPlanes, and at time 0 it is
+ * slot-1 + plane*planePhasing slot spacings past the ascending node (see
+ * OrbitalChannel.ned). Positions are Earth-centered inertial, in km.
+ *
+ * The elements and the positions are kept as structure of arrays. Since all
+ * the satellites share the mean motion, a step rotates every satellite by
+ * the same angle: one sin/cos per step, and a multiply-add loop over the
+ * satellites that the compiler vectorizes, so a step costs O(N).
+ */
+class OrbitPropagator
+{
+  public:
+    static const double EARTH_RADIUS; // km
+    static const double EARTH_MU;     // km^3/s^2
+
+  private:
+    ConstellationConfig config;
+    double radius;         // of the orbits, km
+    double meanMotion;     // rad/s
+    double cosInclination;
+    double sinInclination;
+    double raanSpacing;    // between adjacent planes, rad
+    double slotSpacing;    // between adjacent slots, rad
+    double planePhasing;   // a plane is ahead of the previous one by this, rad
+
+    // the elements of every satellite
+    std::vector<int> planes;
+    std::vector<double> cosRaan;
+    std::vector<double> sinRaan;
+    std::vector<double> cosPhase; // of the argument of latitude at time 0
+    std::vector<double> sinPhase;
+
+    // the state at the time of the last propagate()
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> cosU; // of the argument of latitude, positive on the ascending half
+
+  public:
+    explicit OrbitPropagator(const ConstellationConfig& config);
+
+    // add the satellite with the given address, returns its index
+    int addSatellite(int address);
+    size_t size() const {return planes.size();}
+
+    double getRadius() const {return radius;}
+    double getPeriod() const;
+    bool inSamePlane(int a, int b) const {return planes[a] == planes[b];}
+
+    // compute the positions of all the satellites at the given time, s
+    void propagate(double time);
+
+    // the state after the last propagate()
+    double getDistance(int a, int b) const;
+    double getSinLatitude(int i) const {return z[i] / radius;}
+    // altitude of the lowest point of the line of sight from a to b, km; negative if the Earth is in the way
+    double getGrazingAltitude(int a, int b) const;
+    bool isAscending(int i) const {return cosU[i] > 0;}
+};
+
+#endif
@@ -0,0 +1,108 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "OrbitalChannel.h"
+#include "OrbitPropagator.h"
+using namespace omnetpp;
+
+Define_Channel(OrbitalChannel);
+
+static const double SPEED_OF_LIGHT = 299792.458; // km/s
+
+
+OrbitalChannel::OrbitalChannel(const char *name) : cDatarateChannel(name)
+{
+    geometricDelay = false;
+    period = 0;
+    step = 0;
+}
+
+void OrbitalChannel::initialize()
+{
+    cDatarateChannel::initialize();
+    geometricDelay = par("geometricDelay");
+    if (!geometricDelay)
+        return;
+
+    cGate *srcGate = getSourceGate();
+    cGate *destGate = srcGate->getNextGate();
+    int srcAddress = srcGate->getOwnerModule()->par("address");
+    int destAddress = destGate->getOwnerModule()->par("address");
+    ConstellationConfig config = ConstellationConfig::fromNetwork(getParentModule());
+    this->checkPhasing(config);
+    this->buildDelayTable(config, srcAddress, destAddress);
+}
+
+void OrbitalChannel::checkPhasing(const ConstellationConfig& config)
+{
+    // with the planes all around the globe the first plane follows the last one,
+    // and the link between them (wired with the same slot offset as the others)
+    // only has the phase of the other inter-plane links if the planes together
+    // are shifted by whole turns: numPlanes*planePhasing = 0 mod numSatPerPlane
+    if (fabs(config.raanSpread - 2 * M_PI) > 1e-9)
+        return;
+    double shift = fmod(config.numPlanes * config.planePhasing, config.numSatPerPlane);
+    if (shift < 0)
+        shift += config.numSatPerPlane;
+    if (std::min(shift, config.numSatPerPlane - shift) > 1e-6)
+        throw cRuntimeError("OrbitalChannel: planePhasing=%g breaks the Walker phasing of %d planes of %d satellites, "
+                "num_of_planes*planePhasing must be a multiple of num_of_sat_per_plane", config.planePhasing, config.numPlanes, config.numSatPerPlane);
+}
+
+void OrbitalChannel::buildDelayTable(const ConstellationConfig& config, int srcAddress, int destAddress)
+{
+    OrbitPropagator orbits(config);
+    int src = orbits.addSatellite(srcAddress);
+    int dest = orbits.addSatellite(destAddress);
+    period = orbits.getPeriod();
+
+    int numSamples = 1; // the length of a link within a plane never changes
+    if (!orbits.inSamePlane(src, dest))
+    {
+        numSamples = (int)ceil(period / par("tableStep").doubleValue());
+    }
+    step = period / numSamples;
+
+    delayTable.resize(numSamples + 1);
+    double maxGrazingAltitude = -OrbitPropagator::EARTH_RADIUS;
+    for (int k = 0; k <= numSamples; k++)
+    {
+        orbits.propagate(k * step);
+        delayTable[k] = orbits.getDistance(src, dest) / SPEED_OF_LIGHT;
+        maxGrazingAltitude = std::max(maxGrazingAltitude, orbits.getGrazingAltitude(src, dest));
+    }
+    if (maxGrazingAltitude < 0)
+        throw cRuntimeError("OrbitalChannel: the Earth blocks the link %d->%d for the whole orbit, "
+                "raise orbitAltitude or use more planes", srcAddress, destAddress);
+    EV_DETAIL << "link " << srcAddress << "->" << destAddress << ": " << numSamples
+              << " delay samples, " << delayTable[0] * 1000 << "ms at t=0" << endl;
+}
+
+double OrbitalChannel::getDelayAt(simtime_t t) const
+{
+    if (delayTable.size() == 1)
+        return delayTable[0];
+    double x = fmod(t.dbl(), period) / step;
+    size_t k = (size_t)x;
+    if (k >= delayTable.size() - 1)
+        k = delayTable.size() - 2; // rounding at the end of the orbit
+    double fraction = x - k;
+    return delayTable[k] + fraction * (delayTable[k + 1] - delayTable[k]);
+}
+
+void OrbitalChannel::processMessage(cMessage *msg, simtime_t t, result_t& result)
+{
+    cDatarateChannel::processMessage(msg, t, result);
+    if (geometricDelay && !result.discard)
+    {
+        result.delay = this->getDelayAt(t);
+    }
+}
@@ -0,0 +1,58 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __ORBITALCHANNEL_H
+#define __ORBITALCHANNEL_H
+
+#include <vector>
+#include <omnetpp.h>
+#include "ConstellationConfig.h"
+
+/**
+ * Datarate channel whose propagation delay follows the distance between
+ * the two satellites it connects.
+ *
+ * The satellites fly circular orbits of the same altitude and inclination;
+ * the plane (right ascension of the ascending node) and the position in it
+ * (argument of latitude) come from the (plane, slot) of the node addresses,
+ * see OrbitalChannel.ned and OrbitPropagator. Since all the satellites have the same period,
+ * the distance of two of them repeats every orbit, so it is sampled over
+ * one orbit at tableStep at initialization, and a packet only costs a
+ * linear interpolation in that table. Links within a plane have a fixed
+ * length, their table has a single entry.
+ *
+ * Initialization fails if the orbits cannot carry the link: if the planes
+ * break the Walker phasing constraint, or if the Earth blocks the line of
+ * sight for the whole orbit.
+ *
+ * With geometricDelay=false it is a plain DatarateChannel.
+ */
+class OrbitalChannel : public omnetpp::cDatarateChannel
+{
+  private:
+    bool geometricDelay;
+    double period;                  // orbital period, s
+    double step;                    // time between the samples of the table, s
+    std::vector<double> delayTable; // propagation delay at k*step after an ascending node pass of slot 1
+
+  public:
+    explicit OrbitalChannel(const char *name = nullptr);
+
+    // propagation delay of the link at the given time, s
+    double getDelayAt(omnetpp::simtime_t t) const;
+
+  protected:
+    virtual void initialize() override;
+    virtual void processMessage(omnetpp::cMessage *msg, omnetpp::simtime_t t, result_t& result) override;
+
+    virtual void checkPhasing(const ConstellationConfig& config);
+    virtual void buildDelayTable(const ConstellationConfig& config, int srcAddress, int destAddress);
+};
+
+#endif
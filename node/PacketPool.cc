@@ -0,0 +1,89 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include "PacketPool.h"
+#include "Packet_m.h"
+
+// Packet is customized in Packet.msg, so it is registered here, with its allocation below
+Register_Class(Packet);
+
+const int PacketPool::CHUNK_SIZE;
+
+
+PacketPool::PacketPool(size_t blockSize)
+{
+    // blocks are aligned like anything operator new returns
+    const size_t align = alignof(std::max_align_t);
+    if (blockSize < sizeof(FreeBlock))
+        blockSize = sizeof(FreeBlock);
+    this->blockSize = (blockSize + align - 1) / align * align;
+    freeList = nullptr;
+    numAllocated = 0;
+}
+
+PacketPool::~PacketPool()
+{
+    for (char *chunk : chunks)
+    {
+        ::operator delete(chunk);
+    }
+}
+
+void *PacketPool::allocate()
+{
+    if (freeList == nullptr)
+    {
+        // carve a new chunk into blocks
+        char *chunk = (char *)::operator new(blockSize * CHUNK_SIZE);
+        chunks.push_back(chunk);
+        for (int i = CHUNK_SIZE - 1; i >= 0; i--)
+        {
+            FreeBlock *block = (FreeBlock *)(chunk + i * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+    FreeBlock *block = freeList;
+    freeList = block->next;
+    numAllocated++;
+    return block;
+}
+
+void PacketPool::release(void *p)
+{
+    FreeBlock *block = (FreeBlock *)p;
+    block->next = freeList;
+    freeList = block;
+    numAllocated--;
+}
+
+PacketPool& PacketPool::packets()
+{
+    // constructed on first use, so packets can be created during static initialization too
+    static PacketPool pool(sizeof(Packet));
+    return pool;
+}
+
+void *Packet::operator new(size_t size)
+{
+    // the blocks only fit Packet itself, not subclasses
+    if (size != sizeof(Packet))
+        return ::operator new(size);
+    return PacketPool::packets().allocate();
+}
+
+void Packet::operator delete(void *p, size_t size)
+{
+    if (p == nullptr)
+        return;
+    if (size != sizeof(Packet))
+        ::operator delete(p);
+    else
+        PacketPool::packets().release(p);
+}
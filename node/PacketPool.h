@@ -0,0 +1,55 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __PACKETPOOL_H
+#define __PACKETPOOL_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Free list allocator for the Packet objects, used by Packet's operator
+ * new/delete.
+ *
+ * Every forwarding direction dup()s the packet and every receiver deletes
+ * its copy, so packets are allocated and freed all the time while only a
+ * few thousand are alive at once. Freed blocks are kept on a free list and
+ * reused, new ones are carved from chunks of CHUNK_SIZE blocks. The memory
+ * goes back to the heap only when the program exits. Single threaded, like
+ * the simulation itself.
+ */
+class PacketPool
+{
+  private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    size_t blockSize;
+    FreeBlock *freeList;
+    std::vector<char *> chunks;
+    long numAllocated; // blocks in use
+
+    static const int CHUNK_SIZE = 1024;
+
+  public:
+    PacketPool(size_t blockSize);
+    ~PacketPool();
+
+    void *allocate();
+    void release(void *block);
+    long getNumAllocated() const {return numAllocated;}
+    long getNumChunks() const {return chunks.size();}
+
+    // the pool of the Packet objects
+    static PacketPool& packets();
+};
+
+#endif
@@ -177,9 +177,7 @@ inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
     return out;
 }
 
-Register_Class(Packet)
-
-Packet::Packet(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
+Packet_Base::Packet_Base(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
 {
     this->srcAddr = 0;
     this->intermediateSrcAddr = 0;
@@ -194,19 +192,23 @@ Packet::Packet(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
     this->Wfailed = false;
     this->Efailed = false;
     this->hopCount = 0;
-    this->numPktperMsg = 1; //new
+    this->seqNum = 0;
+    this->numFragments = 1;
+    this->fragmentBits = 0;
+    this->srcIndex = -1;
+    this->destIndex = -1;
 }
 
-Packet::Packet(const Packet& other) : ::omnetpp::cPacket(other)
+Packet_Base::Packet_Base(const Packet_Base& other) : ::omnetpp::cPacket(other)
 {
     copy(other);
 }
 
-Packet::~Packet()
+Packet_Base::~Packet_Base()
 {
 }
 
-Packet& Packet::operator=(const Packet& other)
+Packet_Base& Packet_Base::operator=(const Packet_Base& other)
 {
     if (this==&other) return *this;
     ::omnetpp::cPacket::operator=(other);
@@ -214,7 +216,7 @@ Packet& Packet::operator=(const Packet& other)
     return *this;
 }
 
-void Packet::copy(const Packet& other)
+void Packet_Base::copy(const Packet_Base& other)
 {
     this->srcAddr = other.srcAddr;
     this->intermediateSrcAddr = other.intermediateSrcAddr;
@@ -229,10 +231,14 @@ void Packet::copy(const Packet& other)
     this->Wfailed = other.Wfailed;
     this->Efailed = other.Efailed;
     this->hopCount = other.hopCount;
-    this->numPktperMsg = other.numPktperMsg; //new
+    this->seqNum = other.seqNum;
+    this->numFragments = other.numFragments;
+    this->fragmentBits = other.fragmentBits;
+    this->srcIndex = other.srcIndex;
+    this->destIndex = other.destIndex;
 }
 
-void Packet::parsimPack(omnetpp::cCommBuffer *b) const
+void Packet_Base::parsimPack(omnetpp::cCommBuffer *b) const
 {
     ::omnetpp::cPacket::parsimPack(b);
     doParsimPacking(b,this->srcAddr);
@@ -248,10 +254,14 @@ void Packet::parsimPack(omnetpp::cCommBuffer *b) const
     doParsimPacking(b,this->Wfailed);
     doParsimPacking(b,this->Efailed);
     doParsimPacking(b,this->hopCount);
-    doParsimPacking(b,this->numPktperMsg);// new
+    doParsimPacking(b,this->seqNum);
+    doParsimPacking(b,this->numFragments);
+    doParsimPacking(b,this->fragmentBits);
+    doParsimPacking(b,this->srcIndex);
+    doParsimPacking(b,this->destIndex);
 }
 
-void Packet::parsimUnpack(omnetpp::cCommBuffer *b)
+void Packet_Base::parsimUnpack(omnetpp::cCommBuffer *b)
 {
     ::omnetpp::cPacket::parsimUnpack(b);
     doParsimUnpacking(b,this->srcAddr);
@@ -267,150 +277,193 @@ void Packet::parsimUnpack(omnetpp::cCommBuffer *b)
     doParsimUnpacking(b,this->Wfailed);
     doParsimUnpacking(b,this->Efailed);
     doParsimUnpacking(b,this->hopCount);
-    doParsimUnpacking(b,this->numPktperMsg);// new
+    doParsimUnpacking(b,this->seqNum);
+    doParsimUnpacking(b,this->numFragments);
+    doParsimUnpacking(b,this->fragmentBits);
+    doParsimUnpacking(b,this->srcIndex);
+    doParsimUnpacking(b,this->destIndex);
 
 }
 
-int Packet::getSrcAddr() const
+int Packet_Base::getSrcAddr() const
 {
     return this->srcAddr;
 }
 
-void Packet::setSrcAddr(int srcAddr)
+void Packet_Base::setSrcAddr(int srcAddr)
 {
     this->srcAddr = srcAddr;
 }
 
-int Packet::getIntermediateSrcAddr() const
+int Packet_Base::getIntermediateSrcAddr() const
 {
     return this->intermediateSrcAddr;
 }
 
-void Packet::setIntermediateSrcAddr(int intermediateSrcAddr)
+void Packet_Base::setIntermediateSrcAddr(int intermediateSrcAddr)
 {
     this->intermediateSrcAddr = intermediateSrcAddr;
 }
 
-int Packet::getDestAddr() const
+int Packet_Base::getDestAddr() const
 {
     return this->destAddr;
 }
 
-void Packet::setDestAddr(int destAddr)
+void Packet_Base::setDestAddr(int destAddr)
 {
     this->destAddr = destAddr;
 }
 
-int Packet::getTTL() const
+int Packet_Base::getTTL() const
 {
     return this->TTL;
 }
 
-void Packet::setTTL(int TTL)
+void Packet_Base::setTTL(int TTL)
 {
     this->TTL = TTL;
 }
 
-bool Packet::getReachedJ() const
+bool Packet_Base::getReachedJ() const
 {
     return this->reachedJ;
 }
 
-void Packet::setReachedJ(bool reachedJ)
+void Packet_Base::setReachedJ(bool reachedJ)
 {
     this->reachedJ = reachedJ;
 }
 
-int Packet::getB1() const
+int Packet_Base::getB1() const
 {
     return this->b1;
 }
 
-void Packet::setB1(int b1)
+void Packet_Base::setB1(int b1)
 {
     this->b1 = b1;
 }
 
-int Packet::getB2() const
+int Packet_Base::getB2() const
 {
     return this->b2;
 }
 
-void Packet::setB2(int b2)
+void Packet_Base::setB2(int b2)
 {
     this->b2 = b2;
 }
 
-int Packet::getU() const
+int Packet_Base::getU() const
 {
     return this->u;
 }
 
-void Packet::setU(int u)
+void Packet_Base::setU(int u)
 {
     this->u = u;
 }
 
-int Packet::getV() const
+int Packet_Base::getV() const
 {
     return this->v;
 }
 
-void Packet::setV(int v)
+void Packet_Base::setV(int v)
 {
     this->v = v;
 }
 
-int Packet::getJ() const
+int Packet_Base::getJ() const
 {
     return this->j;
 }
 
-void Packet::setJ(int j)
+void Packet_Base::setJ(int j)
 {
     this->j = j;
 }
 
-bool Packet::getWfailed() const
+bool Packet_Base::getWfailed() const
 {
     return this->Wfailed;
 }
 
-void Packet::setWfailed(bool Wfailed)
+void Packet_Base::setWfailed(bool Wfailed)
 {
     this->Wfailed = Wfailed;
 }
 
-bool Packet::getEfailed() const
+bool Packet_Base::getEfailed() const
 {
     return this->Efailed;
 }
 
-void Packet::setEfailed(bool Efailed)
+void Packet_Base::setEfailed(bool Efailed)
 {
     this->Efailed = Efailed;
 }
 
-int Packet::getHopCount() const
+int Packet_Base::getHopCount() const
 {
     return this->hopCount;
 }
 
-void Packet::setHopCount(int hopCount)
+void Packet_Base::setHopCount(int hopCount)
 {
     this->hopCount = hopCount;
 }
 
-int Packet::getnumPktperMsg() const //new
+int Packet_Base::getSeqNum() const
+{
+    return this->seqNum;
+}
+
+void Packet_Base::setSeqNum(int seqNum)
+{
+    this->seqNum = seqNum;
+}
+
+int Packet_Base::getNumFragments() const
+{
+    return this->numFragments;
+}
+
+void Packet_Base::setNumFragments(int numFragments)
 {
-    return this->numPktperMsg;
+    this->numFragments = numFragments;
 }
 
-void Packet::setnumPktperMsg(int numPktperMsg)
+int Packet_Base::getFragmentBits() const
 {
-    this->numPktperMsg = numPktperMsg;
+    return this->fragmentBits;
 }
 
+void Packet_Base::setFragmentBits(int fragmentBits)
+{
+    this->fragmentBits = fragmentBits;
+}
+
+int Packet_Base::getSrcIndex() const
+{
+    return this->srcIndex;
+}
+
+void Packet_Base::setSrcIndex(int srcIndex)
+{
+    this->srcIndex = srcIndex;
+}
+
+int Packet_Base::getDestIndex() const
+{
+    return this->destIndex;
+}
+
+void Packet_Base::setDestIndex(int destIndex)
+{
+    this->destIndex = destIndex;
+}
 
 class PacketDescriptor : public omnetpp::cClassDescriptor
 {
@@ -454,13 +507,13 @@ PacketDescriptor::~PacketDescriptor()
 
 bool PacketDescriptor::doesSupport(omnetpp::cObject *obj) const
 {
-    return dynamic_cast<Packet *>(obj)!=nullptr;
+    return dynamic_cast<Packet_Base *>(obj)!=nullptr;
 }
 
 const char **PacketDescriptor::getPropertyNames() const
 {
     if (!propertynames) {
-        static const char *names[] = {  nullptr };
+        static const char *names[] = { "customize",  nullptr };
         omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
         const char **basenames = basedesc ? basedesc->getPropertyNames() : nullptr;
         propertynames = mergeLists(basenames, names);
@@ -470,6 +523,7 @@ const char **PacketDescriptor::getPropertyNames() const
 
 const char *PacketDescriptor::getProperty(const char *propertyname) const
 {
+    if (!strcmp(propertyname,"customize")) return "true";
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
     return basedesc ? basedesc->getProperty(propertyname) : nullptr;
 }
@@ -477,7 +531,7 @@ const char *PacketDescriptor::getProperty(const char *propertyname) const
 int PacketDescriptor::getFieldCount() const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
-    return basedesc ? 13+basedesc->getFieldCount() : 13;
+    return basedesc ? 18+basedesc->getFieldCount() : 18;
 }
 
 unsigned int PacketDescriptor::getFieldTypeFlags(int field) const
@@ -502,8 +556,13 @@ unsigned int PacketDescriptor::getFieldTypeFlags(int field) const
         FD_ISEDITABLE,
         FD_ISEDITABLE,
         FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
     };
-    return (field>=0 && field<13) ? fieldTypeFlags[field] : 0;
+    return (field>=0 && field<18) ? fieldTypeFlags[field] : 0;
 }
 
 const char *PacketDescriptor::getFieldName(int field) const
@@ -528,8 +587,13 @@ const char *PacketDescriptor::getFieldName(int field) const
         "Wfailed",
         "Efailed",
         "hopCount",
+        "seqNum",
+        "numFragments",
+        "fragmentBits",
+        "srcIndex",
+        "destIndex",
     };
-    return (field>=0 && field<13) ? fieldNames[field] : nullptr;
+    return (field>=0 && field<18) ? fieldNames[field] : nullptr;
 }
 
 int PacketDescriptor::findField(const char *fieldName) const
@@ -549,6 +613,11 @@ int PacketDescriptor::findField(const char *fieldName) const
     if (fieldName[0]=='W' && strcmp(fieldName, "Wfailed")==0) return base+10;
     if (fieldName[0]=='E' && strcmp(fieldName, "Efailed")==0) return base+11;
     if (fieldName[0]=='h' && strcmp(fieldName, "hopCount")==0) return base+12;
+    if (fieldName[0]=='s' && strcmp(fieldName, "seqNum")==0) return base+13;
+    if (fieldName[0]=='n' && strcmp(fieldName, "numFragments")==0) return base+14;
+    if (fieldName[0]=='f' && strcmp(fieldName, "fragmentBits")==0) return base+15;
+    if (fieldName[0]=='s' && strcmp(fieldName, "srcIndex")==0) return base+16;
+    if (fieldName[0]=='d' && strcmp(fieldName, "destIndex")==0) return base+17;
     return basedesc ? basedesc->findField(fieldName) : -1;
 }
 
@@ -574,8 +643,13 @@ const char *PacketDescriptor::getFieldTypeString(int field) const
         "bool",
         "bool",
         "int",
+        "int",
+        "int",
+        "int",
+        "int",
+        "int",
     };
-    return (field>=0 && field<13) ? fieldTypeStrings[field] : nullptr;
+    return (field>=0 && field<18) ? fieldTypeStrings[field] : nullptr;
 }
 
 const char **PacketDescriptor::getFieldPropertyNames(int field) const
@@ -612,7 +686,7 @@ int PacketDescriptor::getFieldArraySize(void *object, int field) const
             return basedesc->getFieldArraySize(object, field);
         field -= basedesc->getFieldCount();
     }
-    Packet *pp = (Packet *)object; (void)pp;
+    Packet_Base *pp = (Packet_Base *)object; (void)pp;
     switch (field) {
         default: return 0;
     }
@@ -626,7 +700,7 @@ const char *PacketDescriptor::getFieldDynamicTypeString(void *object, int field,
             return basedesc->getFieldDynamicTypeString(object,field,i);
         field -= basedesc->getFieldCount();
     }
-    Packet *pp = (Packet *)object; (void)pp;
+    Packet_Base *pp = (Packet_Base *)object; (void)pp;
     switch (field) {
         default: return nullptr;
     }
@@ -640,7 +714,7 @@ std::string PacketDescriptor::getFieldValueAsString(void *object, int field, int
             return basedesc->getFieldValueAsString(object,field,i);
         field -= basedesc->getFieldCount();
     }
-    Packet *pp = (Packet *)object; (void)pp;
+    Packet_Base *pp = (Packet_Base *)object; (void)pp;
     switch (field) {
         case 0: return long2string(pp->getSrcAddr());
         case 1: return long2string(pp->getIntermediateSrcAddr());
@@ -655,6 +729,11 @@ std::string PacketDescriptor::getFieldValueAsString(void *object, int field, int
         case 10: return bool2string(pp->getWfailed());
         case 11: return bool2string(pp->getEfailed());
         case 12: return long2string(pp->getHopCount());
+        case 13: return long2string(pp->getSeqNum());
+        case 14: return long2string(pp->getNumFragments());
+        case 15: return long2string(pp->getFragmentBits());
+        case 16: return long2string(pp->getSrcIndex());
+        case 17: return long2string(pp->getDestIndex());
         default: return "";
     }
 }
@@ -667,7 +746,7 @@ bool PacketDescriptor::setFieldValueAsString(void *object, int field, int i, con
             return basedesc->setFieldValueAsString(object,field,i,value);
         field -= basedesc->getFieldCount();
     }
-    Packet *pp = (Packet *)object; (void)pp;
+    Packet_Base *pp = (Packet_Base *)object; (void)pp;
     switch (field) {
         case 0: pp->setSrcAddr(string2long(value)); return true;
         case 1: pp->setIntermediateSrcAddr(string2long(value)); return true;
@@ -682,6 +761,11 @@ bool PacketDescriptor::setFieldValueAsString(void *object, int field, int i, con
         case 10: pp->setWfailed(string2bool(value)); return true;
         case 11: pp->setEfailed(string2bool(value)); return true;
         case 12: pp->setHopCount(string2long(value)); return true;
+        case 13: pp->setSeqNum(string2long(value)); return true;
+        case 14: pp->setNumFragments(string2long(value)); return true;
+        case 15: pp->setFragmentBits(string2long(value)); return true;
+        case 16: pp->setSrcIndex(string2long(value)); return true;
+        case 17: pp->setDestIndex(string2long(value)); return true;
         default: return false;
     }
 }
@@ -707,7 +791,7 @@ void *PacketDescriptor::getFieldStructValuePointer(void *object, int field, int
             return basedesc->getFieldStructValuePointer(object, field, i);
         field -= basedesc->getFieldCount();
     }
-    Packet *pp = (Packet *)object; (void)pp;
+    Packet_Base *pp = (Packet_Base *)object; (void)pp;
     switch (field) {
         default: return nullptr;
     }
@@ -19,17 +19,20 @@
 
 
 /**
- * Class generated from <tt>node/Packet.msg:14</tt> by nedtool.
+ * Class generated from <tt>node/Packet.msg:15</tt> by nedtool.
  * <pre>
  * //
  * // Represents a packet in the network.
+ * // Customized: Packet, derived from the generated Packet_Base below, adds
+ * // the allocation from PacketPool and the numPktperMsg counter.
  * //
  * packet Packet
  * {
+ *     @customize(true);
  *     int srcAddr;
  *     int intermediateSrcAddr;
  *     int destAddr;	// to be changed every hop
- * 
+ *     
  *     // algos parameters
  *     int TTL;
  *     bool reachedJ;
@@ -40,13 +43,50 @@
  *     int j;
  *     bool Wfailed;
  *     bool Efailed;
- * 
+ *     
  *     // statistics
  *     int hopCount;
+ * 
+ *     // per-source sequence number of the fragment, for duplicate suppression
+ *     int seqNum;
+ * 
+ *     // fragment train: the packet carries numFragments consecutive fragments,
+ *     // seqNum and numPktperMsg are those of the first one, all but the last
+ *     // one are fragmentBits long
+ *     int numFragments = 1;
+ *     int fragmentBits;
+ * 
+ *     // dense node indices of srcAddr and destAddr (see RoutingDatabase), -1 if not set
+ *     int srcIndex = -1;
+ *     int destIndex = -1;
  * }
  * </pre>
+ *
+ * Packet_Base is only useful if it gets subclassed, and Packet is derived from it.
+ * The minimum code to be written for Packet is the following:
+ *
+ * <pre>
+ * class Packet : public Packet_Base
+ * {
+ *   private:
+ *     void copy(const Packet& other) { ... }
+
+ *   public:
+ *     Packet(const char *name=nullptr, short kind=0) : Packet_Base(name,kind) {}
+ *     Packet(const Packet& other) : Packet_Base(other) {copy(other);}
+ *     Packet& operator=(const Packet& other) {if (this==&other) return *this; Packet_Base::operator=(other); copy(other); return *this;}
+ *     virtual Packet *dup() const override {return new Packet(*this);}
+ *     // ADD CODE HERE to redefine and implement pure virtual functions from Packet_Base
+ * };
+ * </pre>
+ *
+ * The following should go into a .cc (.cpp) file:
+ *
+ * <pre>
+ * Register_Class(Packet)
+ * </pre>
  */
-class Packet : public ::omnetpp::cPacket
+class Packet_Base : public ::omnetpp::cPacket
 {
   protected:
     int srcAddr;
@@ -62,21 +102,27 @@ class Packet : public ::omnetpp::cPacket
     bool Wfailed;
     bool Efailed;
     int hopCount;
-    int numPktperMsg;
+    int seqNum;
+    int numFragments;
+    int fragmentBits;
+    int srcIndex;
+    int destIndex;
 
   private:
-    void copy(const Packet& other);
+    void copy(const Packet_Base& other);
 
   protected:
     // protected and unimplemented operator==(), to prevent accidental usage
-    bool operator==(const Packet&);
+    bool operator==(const Packet_Base&);
+    // make constructors protected to avoid instantiation
+    Packet_Base(const char *name=nullptr, short kind=0);
+    Packet_Base(const Packet_Base& other);
+    // make assignment operator protected to force the user override it
+    Packet_Base& operator=(const Packet_Base& other);
 
   public:
-    Packet(const char *name=nullptr, short kind=0);
-    Packet(const Packet& other);
-    virtual ~Packet();
-    Packet& operator=(const Packet& other);
-    virtual Packet *dup() const override {return new Packet(*this);}
+    virtual ~Packet_Base();
+    virtual Packet_Base *dup() const override {throw omnetpp::cRuntimeError("You forgot to manually add a dup() function to class Packet");}
     virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
     virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
 
@@ -107,15 +153,46 @@ class Packet : public ::omnetpp::cPacket
     virtual void setEfailed(bool Efailed);
     virtual int getHopCount() const;
     virtual void setHopCount(int hopCount);
-    virtual int getnumPktperMsg() const;// new
-    virtual void setnumPktperMsg(int numPktperMsg); //new
+    virtual int getSeqNum() const;
+    virtual void setSeqNum(int seqNum);
+    virtual int getNumFragments() const;
+    virtual void setNumFragments(int numFragments);
+    virtual int getFragmentBits() const;
+    virtual void setFragmentBits(int fragmentBits);
+    virtual int getSrcIndex() const;
+    virtual void setSrcIndex(int srcIndex);
+    virtual int getDestIndex() const;
+    virtual void setDestIndex(int destIndex);
 };
 
-inline void doParsimPacking(omnetpp::cCommBuffer *b, const Packet& obj) {obj.parsimPack(b);}
-inline void doParsimUnpacking(omnetpp::cCommBuffer *b, Packet& obj) {obj.parsimUnpack(b);}
+// cplusplus {{
+class Packet : public Packet_Base
+{
+  protected:
+    int numPktperMsg = 1;
+
+  private:
+    void copy(const Packet& other) {numPktperMsg = other.numPktperMsg;}
+
+  public:
+    Packet(const char *name=nullptr, short kind=0) : Packet_Base(name,kind) {}
+    Packet(const Packet& other) : Packet_Base(other) {copy(other);}
+    Packet& operator=(const Packet& other) {if (this==&other) return *this; Packet_Base::operator=(other); copy(other); return *this;}
+    virtual Packet *dup() const override {return new Packet(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override {Packet_Base::parsimPack(b); b->pack(numPktperMsg);}
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override {Packet_Base::parsimUnpack(b); b->unpack(numPktperMsg);}
+
+    // packets are allocated from PacketPool, see PacketPool.cc
+    static void *operator new(size_t size);
+    static void operator delete(void *p, size_t size);
+
+    virtual int getnumPktperMsg() const {return numPktperMsg;}
+    virtual void setnumPktperMsg(int numPktperMsg) {this->numPktperMsg = numPktperMsg;}
+};
+// }}
 
 /**
- * Class generated from <tt>node/Packet.msg:35</tt> by nedtool.
+ * Class generated from <tt>node/Packet.msg:76</tt> by nedtool.
  * <pre>
  * message Control
  * {
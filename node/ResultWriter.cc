@@ -0,0 +1,260 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <string.h>
+#include "ResultWriter.h"
+using namespace omnetpp;
+
+Define_Module(ResultWriter);
+
+const uint32_t ResultWriter::EVENTLOG_VERSION;
+
+
+ResultWriter::ResultWriter()
+{
+    // Apps may write before this module is initialized
+    started = false;
+    async = false;
+    blockSize = 0;
+    buffered = 0;
+    writing = false;
+    stopping = false;
+    textFiles = true;
+    eventLog = -1;
+}
+
+ResultWriter::~ResultWriter()
+{
+    // the simulation may end without finish(), e.g. on an error
+    try {
+        this->close();
+    }
+    catch (std::exception&) {
+    }
+}
+
+void ResultWriter::initialize()
+{
+    this->ensureStarted();
+}
+
+void ResultWriter::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("ResultWriter does not process messages");
+}
+
+void ResultWriter::finish()
+{
+    this->close();
+}
+
+void ResultWriter::ensureStarted()
+{
+    if (started)
+        return;
+    started = true;
+
+    async = par("asyncWrite");
+    blockSize = (size_t)par("blockSize").intValue();
+    stopping = false;
+    if (async)
+    {
+        writer = std::thread(&ResultWriter::writerLoop, this);
+    }
+
+    textFiles = par("textFiles");
+    std::string eventLogFile = par("eventLog").stdstringValue();
+    if (!eventLogFile.empty())
+    {
+        // a new file every run, starting with the header
+        eventLog = this->getStream(eventLogFile, "wb");
+        char header[16] = "LPVSLOG";
+        uint32_t version = EVENTLOG_VERSION;
+        uint32_t recordSize = sizeof(EventRecord);
+        memcpy(header + 8, &version, 4);
+        memcpy(header + 12, &recordSize, 4);
+        this->append(eventLog, header, sizeof(header));
+    }
+}
+
+int ResultWriter::getStream(const std::string& fileName, const char *mode)
+{
+    this->ensureStarted();
+    auto it = streamOfFile.find(fileName);
+    if (it != streamOfFile.end())
+        return it->second;
+
+    Stream stream;
+    stream.fileName = fileName;
+    stream.file = fopen(fileName.c_str(), mode);
+    if (stream.file == NULL)
+    {
+        throw cRuntimeError("Error opening file %s", fileName.c_str());
+    }
+    streams.push_back(stream);
+    streamOfFile[fileName] = streams.size() - 1;
+    return streams.size() - 1;
+}
+
+void ResultWriter::append(int stream, const std::string& data)
+{
+    this->append(stream, data.data(), data.size());
+}
+
+void ResultWriter::append(int stream, const void *data, size_t size)
+{
+    streams[stream].buffer.append((const char *)data, size);
+    buffered += size;
+    if (buffered >= blockSize)
+    {
+        this->handOver();
+    }
+}
+
+bool ResultWriter::writesTextFiles()
+{
+    this->ensureStarted();
+    return textFiles;
+}
+
+bool ResultWriter::writesEventLog()
+{
+    this->ensureStarted();
+    return eventLog != -1;
+}
+
+void ResultWriter::logEvent(const EventRecord& record)
+{
+    this->append(eventLog, &record, sizeof(record));
+}
+
+void ResultWriter::handOver()
+{
+    // move the filled buffers to the writer, or write them right here
+    this->checkError();
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        Stream& stream = streams[i];
+        if (stream.buffer.empty())
+            continue;
+        if (async)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            blocks.push_back(Block());
+            blocks.back().file = stream.file;
+            blocks.back().fileName = stream.fileName;
+            blocks.back().data.swap(stream.buffer);
+        }
+        else
+        {
+            if (fwrite(stream.buffer.data(), 1, stream.buffer.size(), stream.file) != stream.buffer.size())
+                throw cRuntimeError("Error writing file %s", stream.fileName.c_str());
+            stream.buffer.clear();
+        }
+    }
+    buffered = 0;
+    if (async)
+    {
+        wakeup.notify_one();
+    }
+}
+
+void ResultWriter::flush()
+{
+    this->handOver();
+    if (async)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        drained.wait(guard, [this] { return blocks.empty() && !writing; });
+    }
+    for (auto& stream : streams)
+    {
+        fflush(stream.file);
+    }
+    this->checkError();
+}
+
+void ResultWriter::close()
+{
+    if (!started)
+        return;
+    started = false;
+
+    // the writer must be joined and the files closed even if writing failed,
+    // the error is only reported afterwards
+    std::string error;
+    try
+    {
+        this->flush();
+    }
+    catch (std::exception& e)
+    {
+        error = e.what();
+    }
+    if (writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wakeup.notify_one();
+        writer.join();
+    }
+    for (auto& stream : streams)
+    {
+        fclose(stream.file);
+    }
+    streams.clear();
+    streamOfFile.clear();
+    eventLog = -1;
+
+    if (!writeError.empty())
+        error = writeError;
+    if (!error.empty())
+        throw cRuntimeError("%s", error.c_str());
+}
+
+void ResultWriter::checkError()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if (!writeError.empty())
+    {
+        throw cRuntimeError("%s", writeError.c_str());
+    }
+}
+
+void ResultWriter::writerLoop()
+{
+    // runs in the background thread, the files are only touched here while it runs
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
+    {
+        wakeup.wait(guard, [this] { return stopping || !blocks.empty(); });
+        if (blocks.empty())
+            break; // stopping, and everything is written
+        Block block;
+        std::swap(block, blocks.front());
+        blocks.pop_front();
+        writing = true;
+        guard.unlock();
+
+        bool ok = fwrite(block.data.data(), 1, block.data.size(), block.file) == block.data.size();
+
+        guard.lock();
+        if (!ok && writeError.empty())
+        {
+            writeError = "Error writing file " + block.fileName;
+        }
+        writing = false;
+        if (blocks.empty())
+        {
+            drained.notify_all();
+        }
+    }
+}
@@ -0,0 +1,127 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __RESULTWRITER_H
+#define __RESULTWRITER_H
+
+#include <stdio.h>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <omnetpp.h>
+
+// one event of the binary event log, 40 bytes in native byte order
+struct EventRecord
+{
+    double time;      // received: creation time of the message, sent: sending time
+    double latency;   // received only
+    int32_t kind;     // EVENT_RECEIVED or EVENT_SENT
+    int32_t sender;
+    int32_t receiver; // -1 for sent messages
+    int32_t fragment;
+    int32_t hops;
+    int32_t bits;
+};
+
+enum { EVENT_RECEIVED = 0, EVENT_SENT = 1 };
+
+/**
+ * Shared writer of the per-satellite result files (outfiles/recvN.csv,
+ * outfiles/sentN.csv).
+ *
+ * Every file is opened once, in append mode, and the lines are collected in
+ * a memory buffer per file. When the buffers together exceed blockSize they
+ * are handed over to a background thread that writes them out, so the event
+ * loop never waits for the disk. Everything is flushed and the files are
+ * closed in finish(), or when the module is deleted.
+ *
+ * Optionally all the Apps log their events into one binary file of fixed
+ * size EventRecords instead of (or besides) the text files. The file starts
+ * with a 16 byte header: the magic "LPVSLOG\0", the format version and the
+ * record size as 32-bit integers. tools/export_eventlog.py converts it to
+ * CSV (also split into recvN.csv and sending time files) or Parquet.
+ */
+class ResultWriter : public omnetpp::cSimpleModule
+{
+  private:
+    struct Stream
+    {
+        std::string fileName;
+        FILE *file;
+        std::string buffer; // not handed over to the writer yet
+    };
+
+    // data handed over to the background writer
+    struct Block
+    {
+        FILE *file;
+        std::string fileName;
+        std::string data;
+    };
+
+    bool started;
+    bool async;
+    size_t blockSize;
+    size_t buffered; // bytes in the buffers of all the streams
+    std::vector<Stream> streams;
+    std::unordered_map<std::string, int> streamOfFile;
+    bool textFiles;
+    int eventLog; // stream of the binary event log, -1 if disabled
+
+    // background writer
+    std::thread writer;
+    std::mutex lock;
+    std::condition_variable wakeup;
+    std::condition_variable drained;
+    std::deque<Block> blocks; // waiting to be written
+    bool writing;
+    bool stopping;
+    std::string writeError; // first error of the writer thread
+
+  public:
+    ResultWriter();
+    virtual ~ResultWriter();
+
+    static const uint32_t EVENTLOG_VERSION = 1;
+
+    // handle of the stream of a file, opened (with the fopen() mode) on the first request
+    int getStream(const std::string& fileName, const char *mode = "a");
+
+    // append data to the stream, it reaches the file at the latest in finish()
+    void append(int stream, const std::string& data);
+    void append(int stream, const void *data, size_t size);
+
+    // which outputs are enabled
+    bool writesTextFiles();
+    bool writesEventLog();
+
+    // add a record to the binary event log
+    void logEvent(const EventRecord& record);
+
+    // hand all the buffered data over to the writer and wait until it is written
+    void flush();
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+
+    virtual void ensureStarted();
+    virtual void handOver();
+    virtual void close();
+    virtual void checkError();
+    void writerLoop();
+};
+
+#endif
@@ -11,21 +11,21 @@
 #pragma warning(disable:4786)
 #endif
 
-#include <map>
 #include <omnetpp.h>
 #include "Packet_m.h"
+#include "RoutingDatabase.h"
 using namespace omnetpp;
 
 /**
- * Demonstrates static routing, utilizing the cTopology class.
+ * Static routing, with the next hops served by the shared RoutingDatabase.
  */
 class Routing : public cSimpleModule
 {
   private:
     int myAddress;
+    int myIndex; // index of this node in the routing database
 
-    typedef std::map<int,int> RoutingTable; // destaddr -> gateindex
-    RoutingTable rtable;
+    RoutingDatabase *routingDatabase;
 
     simsignal_t dropSignal;
     simsignal_t outputIfSignal;
@@ -45,36 +45,9 @@ void Routing::initialize()
     dropSignal = registerSignal("drop");
     outputIfSignal = registerSignal("outputIf");
 
-    //
-    // Brute force approach -- every node does topology discovery on its own,
-    // and finds routes to all other nodes independently, at the beginning
-    // of the simulation. This could be improved: (1) central routing database,
-    // (2) on-demand route calculation
-    //
-    cTopology *topo = new cTopology("topo");
-
-    std::vector<std::string> nedTypes;
-    nedTypes.push_back(getParentModule()->getNedTypeName());
-    topo->extractByNedTypeName(nedTypes);
-    //EV << "cTopology found " << topo->getNumNodes() << " nodes\n";
-
-    cTopology::Node *thisNode = topo->getNodeFor(getParentModule());
-
-    // find and store next hops
-    for (int i=0; i<topo->getNumNodes(); i++)
-    {
-        if (topo->getNode(i)==thisNode) continue; // skip ourselves
-        topo->calculateUnweightedSingleShortestPathsTo(topo->getNode(i));
-
-        if (thisNode->getNumPaths()==0) continue; // not connected
-
-        cGate *parentModuleGate = thisNode->getPath(0)->getLocalGate();
-        int gateIndex = parentModuleGate->getIndex();
-        int address = topo->getNode(i)->getModule()->par("address");
-        rtable[address] = gateIndex;
-        //EV << "  towards address " << address << " gateIndex is " << gateIndex << endl;
-    }
-    delete topo;
+    // the routes of all the nodes are computed once, by the central routing database
+    routingDatabase = check_and_cast<RoutingDatabase *>(getParentModule()->getParentModule()->getSubmodule("routingDatabase"));
+    myIndex = routingDatabase->getNodeIndex(myAddress);
 }
 
 void Routing::handleMessage(cMessage *msg)
@@ -90,8 +63,12 @@ void Routing::handleMessage(cMessage *msg)
         return;
     }
 
-    RoutingTable::iterator it = rtable.find(destAddr);
-    if (it==rtable.end())
+    // the App puts the dense index of the destination into the packet
+    int destIndex = pk->getDestIndex();
+    if (destIndex < 0)
+        destIndex = routingDatabase->getNodeIndex(destAddr);
+    int outGateIndex = routingDatabase->getNextHopGateToIndex(myIndex, destIndex);
+    if (outGateIndex == -1)
     {
         EV << "address " << destAddr << " unreachable, discarding packet " << pk->getName() << endl;
         emit(dropSignal, (long)pk->getByteLength());
@@ -99,7 +76,6 @@ void Routing::handleMessage(cMessage *msg)
         return;
     }
 
-    int outGateIndex = (*it).second;
     //EV << "forwarding packet " << pk->getName() << " on gate index " << outGateIndex << endl;
     pk->setHopCount(pk->getHopCount()+1);
     emit(outputIfSignal, outGateIndex);
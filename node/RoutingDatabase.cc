@@ -0,0 +1,223 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include "RoutingDatabase.h"
+using namespace omnetpp;
+
+Define_Module(RoutingDatabase);
+
+
+RoutingDatabase::RoutingDatabase()
+{
+    // Routing modules may query before this module is initialized
+    built = false;
+    numRecomputations = 0;
+}
+
+void RoutingDatabase::initialize()
+{
+    this->ensureBuilt();
+    WATCH(numRecomputations);
+}
+
+void RoutingDatabase::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("RoutingDatabase does not process messages");
+}
+
+void RoutingDatabase::ensureBuilt()
+{
+    if (built)
+        return;
+    built = true;
+
+    this->extractTopology();
+
+    // the routes towards a destination are computed on its first query
+    int numNodes = nodes.size();
+    nextHop.assign((size_t)numNodes * numNodes, -1);
+    distance.assign((size_t)numNodes * numNodes, -1);
+    stale.assign(numNodes, true);
+    EV << "routing database: " << numNodes << " nodes, " << links.size() << " links" << endl;
+}
+
+void RoutingDatabase::extractTopology()
+{
+    // the nodes are the submodules of the network of the given NED type
+    const char *nodeType = par("nodeType");
+    cModule *network = getParentModule();
+    for (cModule::SubmoduleIterator it(network); !it.end(); ++it)
+    {
+        cModule *module = *it;
+        if (strcmp(module->getNedTypeName(), nodeType) == 0)
+        {
+            nodes.push_back(module);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end(),
+            [](cModule *a, cModule *b) { return a->getId() < b->getId(); });
+
+    std::unordered_map<cModule *, int> indexOfModule;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        int address = nodes[i]->par("address");
+        if (address < 0)
+            throw cRuntimeError("RoutingDatabase: negative address %d of %s", address, nodes[i]->getFullPath().c_str());
+        addresses.push_back(address);
+        if ((size_t)address >= indexOfAddress.size())
+            indexOfAddress.resize(address + 1, -1);
+        indexOfAddress[address] = i;
+        indexOfModule[nodes[i]] = i;
+    }
+
+    // a link for every port that leads to another node
+    std::vector<int> numInLinks(nodes.size() + 1, 0);
+    outOffset.assign(nodes.size() + 1, 0);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        outOffset[i] = links.size();
+        for (int g = 0; g < nodes[i]->gateSize("port$o"); g++)
+        {
+            cGate *gate = nodes[i]->gate("port$o", g)->getNextGate();
+            auto it = indexOfModule.end();
+            while (gate != NULL && (it = indexOfModule.find(gate->getOwnerModule())) == indexOfModule.end())
+            {
+                gate = gate->getNextGate();
+            }
+            if (gate == NULL)
+                continue;
+            Link link = {(int)i, it->second, g, true};
+            links.push_back(link);
+            numInLinks[link.dest + 1]++;
+        }
+    }
+    outOffset[nodes.size()] = links.size();
+
+    // index the links by the node they enter, keeping their order
+    inOffset.assign(nodes.size() + 1, 0);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        inOffset[i + 1] = inOffset[i] + numInLinks[i + 1];
+    }
+    inLinks.assign(links.size(), -1);
+    std::vector<int> fill(inOffset.begin(), inOffset.end() - 1);
+    for (size_t l = 0; l < links.size(); l++)
+    {
+        inLinks[fill[links[l].dest]++] = l;
+    }
+}
+
+void RoutingDatabase::computeRoutesTo(int dest)
+{
+    // BFS backwards from dest over the links that are up, the first link to reach a node is its next hop
+    size_t numNodes = nodes.size();
+    for (size_t src = 0; src < numNodes; src++)
+    {
+        nextHop[src * numNodes + dest] = -1;
+        distance[src * numNodes + dest] = -1;
+    }
+    queue.clear();
+    distance[dest * numNodes + dest] = 0;
+    queue.push_back(dest);
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int v = queue[head];
+        short dist = distance[v * numNodes + dest];
+        for (int k = inOffset[v]; k < inOffset[v + 1]; k++)
+        {
+            const Link& link = links[inLinks[k]];
+            if (link.up && distance[link.src * numNodes + dest] == -1)
+            {
+                distance[link.src * numNodes + dest] = dist + 1;
+                nextHop[link.src * numNodes + dest] = link.gateIndex;
+                queue.push_back(link.src);
+            }
+        }
+    }
+    stale[dest] = false;
+    numRecomputations++;
+}
+
+void RoutingDatabase::setLinkState(int srcAddress, int destAddress, bool up)
+{
+    Enter_Method_Silent();
+    int src = this->getNodeIndex(srcAddress);
+    int dest = this->getNodeIndex(destAddress);
+    if (src < 0 || dest < 0)
+        return;
+
+    size_t numNodes = nodes.size();
+    for (int l = outOffset[src]; l < outOffset[src + 1]; l++)
+    {
+        Link& link = links[l];
+        if (link.dest != dest || link.up == up)
+            continue;
+        link.up = up;
+
+        // mark the destinations whose routes may change
+        for (size_t t = 0; t < numNodes; t++)
+        {
+            if (stale[t])
+                continue;
+            if (!up)
+            {
+                // only the routes that went through the link
+                stale[t] = nextHop[src * numNodes + t] == link.gateIndex;
+            }
+            else
+            {
+                // the link may give src a shorter (or an equally short, earlier found) path
+                short srcDist = distance[src * numNodes + t];
+                short destDist = distance[dest * numNodes + t];
+                stale[t] = destDist != -1 && (srcDist == -1 || srcDist > destDist);
+            }
+        }
+    }
+}
+
+int RoutingDatabase::getNodeIndex(int address)
+{
+    Enter_Method_Silent();
+    this->ensureBuilt();
+    if (address < 0 || (size_t)address >= indexOfAddress.size())
+        return -1;
+    return indexOfAddress[address];
+}
+
+int RoutingDatabase::getAddress(int index)
+{
+    Enter_Method_Silent();
+    this->ensureBuilt();
+    return addresses.at(index);
+}
+
+int RoutingDatabase::getNumNodes()
+{
+    Enter_Method_Silent();
+    this->ensureBuilt();
+    return nodes.size();
+}
+
+int RoutingDatabase::getNextHopGate(int srcIndex, int destAddress)
+{
+    return this->getNextHopGateToIndex(srcIndex, this->getNodeIndex(destAddress));
+}
+
+int RoutingDatabase::getNextHopGateToIndex(int srcIndex, int destIndex)
+{
+    Enter_Method_Silent();
+    if (srcIndex < 0 || destIndex < 0)
+        return -1;
+    if (stale[destIndex])
+        this->computeRoutesTo(destIndex);
+    return nextHop[(size_t)srcIndex * nodes.size() + destIndex];
+}
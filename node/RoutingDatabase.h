@@ -0,0 +1,94 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __ROUTINGDATABASE_H
+#define __ROUTINGDATABASE_H
+
+#include <vector>
+#include <omnetpp.h>
+
+/**
+ * Central routing database shared by all the Routing modules.
+ *
+ * The topology of the nodes is extracted once, and one BFS per destination
+ * fills the next hop of every node towards it, so all the routes cost
+ * O(N*(N+E)) in total instead of every node running its own cTopology
+ * search. Next hops are kept as port gate indices in an N x N matrix.
+ *
+ * Nodes are taken in module id order and links in gate order, the same
+ * order cTopology uses, so the routes (including the tie breaks between
+ * equally short paths) are the same as cTopology's unweighted single
+ * shortest paths.
+ *
+ * Links can be taken down and up again with setLinkState() (App does so on
+ * the connect/disconnect events of the scenario). A change only marks the
+ * destinations whose routes it can affect, judged from the next hop and
+ * distance of the link's end nodes, and the routes towards a marked
+ * destination are recomputed on the next query for it. Routes are also
+ * computed on demand the first time, so destinations that never get
+ * traffic cost nothing.
+ *
+ * The node index doubles as the dense id of a satellite (0..N-1): Apps put
+ * it into the packets (srcIndex/destIndex), so forwarding is one indexed
+ * load from the next hop matrix, and addresses map to it through a flat
+ * table instead of a hash lookup.
+ */
+class RoutingDatabase : public omnetpp::cSimpleModule
+{
+  private:
+    // a link of the topology, leaving node src on port gateIndex and entering node dest
+    struct Link
+    {
+        int src;
+        int dest;
+        int gateIndex;
+        bool up;
+    };
+
+    bool built;
+    std::vector<omnetpp::cModule *> nodes; // in module id order
+    std::vector<int> addresses;
+    std::vector<int> indexOfAddress; // address -> node index, -1 if there is no such node
+
+    std::vector<Link> links;   // ordered by src, the links leaving node i are links[outOffset[i] .. outOffset[i+1])
+    std::vector<int> outOffset;
+    std::vector<int> inOffset; // the links entering node i are inLinks[inOffset[i] .. inOffset[i+1])
+    std::vector<int> inLinks;
+
+    std::vector<short> nextHop; // nextHop[src * N + dest]: port gate index at src, -1 if unreachable
+    std::vector<short> distance; // distance[src * N + dest] in hops, -1 if unreachable
+    std::vector<char> stale;     // the routes towards a destination must be recomputed before use
+    std::vector<int> queue;
+    long numRecomputations;
+
+  public:
+    RoutingDatabase();
+
+    // index of the node with the given address, -1 if there is none
+    int getNodeIndex(int address);
+    int getAddress(int index);
+    int getNumNodes();
+
+    // port gate index at the given node towards the destination, -1 if unreachable
+    int getNextHopGate(int srcIndex, int destAddress);
+    int getNextHopGateToIndex(int srcIndex, int destIndex);
+
+    // take the link from srcAddress to its neighbor destAddress down or up
+    void setLinkState(int srcAddress, int destAddress, bool up);
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+
+    virtual void ensureBuilt();
+    virtual void extractTopology();
+    virtual void computeRoutesTo(int dest);
+};
+
+#endif
@@ -0,0 +1,385 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "ScenarioFile.h"
+
+namespace {
+
+const char MAGIC[8] = {'L', 'P', 'V', 'S', 'S', 'C', 'N', '\0'};
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numColumns;
+    int64_t sourceSize[ScenarioFile::NUM_SOURCES];
+    int64_t sourceMtime[ScenarioFile::NUM_SOURCES];
+};
+
+struct ColumnEntry
+{
+    uint32_t id;
+    uint32_t elemSize;
+    uint64_t count;
+    uint64_t offset;
+};
+
+// size and modification time of a sheet, -1 if it is not used or missing
+void statSource(const std::string& fileName, int64_t& size, int64_t& mtime)
+{
+    struct stat st;
+    if (fileName.empty() || stat(fileName.c_str(), &st) != 0)
+    {
+        size = mtime = -1;
+        return;
+    }
+    size = st.st_size;
+    mtime = st.st_mtime;
+}
+
+// calls the visitor for every column, in the order of the column ids
+template <typename Visitor>
+void visitColumns(ScenarioFile& f, Visitor& visit)
+{
+    visit(f.connStart); visit(f.connStop); visit(f.connTo); visit(f.connFrom); visit(f.connAscending);
+    visit(f.timeIsStart); visit(f.timeSat); visit(f.timeSec);
+    visit(f.trafficSat); visit(f.trafficTime); visit(f.trafficNorth); visit(f.trafficAmount);
+}
+
+struct OwnVisitor
+{
+    template <typename T> void operator()(ScenarioColumn<T>& column) {column.own();}
+};
+
+struct CountVisitor
+{
+    uint32_t numColumns = 0;
+    template <typename T> void operator()(ScenarioColumn<T>&) {numColumns++;}
+};
+
+// lays out the directory entries of the columns
+struct LayoutVisitor
+{
+    std::vector<ColumnEntry> entries;
+    uint64_t offset;
+
+    template <typename T> void operator()(ScenarioColumn<T>& column)
+    {
+        ColumnEntry entry;
+        entry.id = entries.size();
+        entry.elemSize = sizeof(T);
+        entry.count = column.size();
+        entry.offset = offset;
+        entries.push_back(entry);
+        offset += (entry.count * sizeof(T) + 7) & ~uint64_t(7);
+    }
+};
+
+struct WriteVisitor
+{
+    std::ofstream& out;
+
+    template <typename T> void operator()(ScenarioColumn<T>& column)
+    {
+        size_t bytes = column.size() * sizeof(T);
+        if (bytes > 0)
+            out.write(reinterpret_cast<const char *>(column.values), bytes);
+        static const char padding[8] = {0};
+        out.write(padding, ((bytes + 7) & ~size_t(7)) - bytes);
+    }
+};
+
+// points the columns into the mapped file; false if the directory doesn't match this version
+struct MapVisitor
+{
+    const char *base;
+    size_t size;
+    const ColumnEntry *entries;
+    uint32_t next = 0;
+    bool ok = true;
+
+    template <typename T> void operator()(ScenarioColumn<T>& column)
+    {
+        const ColumnEntry& entry = entries[next];
+        if (entry.id != next || entry.elemSize != sizeof(T) || entry.offset % 8 != 0 || entry.offset + entry.count * sizeof(T) > size)
+            ok = false;
+        else
+        {
+            column.values = reinterpret_cast<const T *>(base + entry.offset);
+            column.count = entry.count;
+        }
+        next++;
+    }
+};
+
+} // namespace
+
+
+ScenarioFile::ScenarioFile()
+{
+    mapping = NULL;
+    mappingSize = 0;
+}
+
+ScenarioFile::~ScenarioFile()
+{
+    this->unmap();
+}
+
+void ScenarioFile::setSources(const std::string& connections, const std::string& satTimes, const std::string& traffic)
+{
+    sources[CONNECTIONS] = connections;
+    sources[SAT_TIMES] = satTimes;
+    sources[TRAFFIC] = traffic;
+}
+
+void ScenarioFile::ownAll()
+{
+    OwnVisitor visitor;
+    visitColumns(*this, visitor);
+}
+
+void ScenarioFile::readSheets()
+{
+    this->unmap();
+    this->readConnections(sources[CONNECTIONS]);
+    this->readSatelliteTimes(sources[SAT_TIMES]);
+    this->readTraffic(sources[TRAFFIC]);
+    this->ownAll();
+}
+
+void ScenarioFile::readConnections(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    std::string line;
+
+    // skip the first line of the file
+    getline(file, line);
+
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (std::getline(iss, token, ',')) {
+            tokens.push_back(token);
+        }
+
+        connStart.push_back(std::stod(tokens[0]));
+        connStop.push_back(std::stod(tokens[1]));
+        connTo.push_back(std::stoi(tokens[2]));
+        connFrom.push_back(std::stoi(tokens[3]));
+        connAscending.push_back(std::stoi(tokens[4]));
+    }
+}
+
+void ScenarioFile::readSatelliteTimes(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    std::string line;
+
+    getline(file, line); // skip header
+
+    while (getline(file, line)) {
+        std::stringstream ss(line);
+        std::string status, satellite, time_sec;
+        getline(ss, status, ',');
+        getline(ss, satellite, ',');
+        getline(ss, time_sec);
+
+        // rows other than START and STOP carry no information
+        if (status != "START" && status != "STOP")
+            continue;
+
+        timeIsStart.push_back(status == "START" ? 1 : 0);
+        timeSat.push_back(stoi(satellite));
+        timeSec.push_back(stoi(time_sec));
+    }
+}
+
+void ScenarioFile::readTraffic(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    std::string line;
+
+    // skip the first line of the file
+    getline(file, line);
+
+    while (getline(file, line))
+    {
+        std::stringstream ss(line);
+        std::string cell;
+        int col = 0, address = 0, time = 0, amount = 0;
+        std::string north;
+
+        while (std::getline(ss, cell, ',')) {
+            ++col;
+            if (col == 1) {
+                address = std::stoi(cell);
+            } else if (col == 2) {
+                time = std::stoi(cell);
+            } else if (col == 3) {
+                north = cell;
+            } else if (col == 4) {
+                amount = std::stoi(cell);
+            }
+        }
+
+        trafficSat.push_back(address);
+        trafficTime.push_back(time);
+        trafficNorth.push_back(north == "True" ? 1 : 0);
+        trafficAmount.push_back(amount);
+    }
+}
+
+void ScenarioFile::write(const std::string& fileName) const
+{
+    ScenarioFile& self = const_cast<ScenarioFile&>(*this);
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    for (int i = 0; i < NUM_SOURCES; i++)
+        statSource(sources[i], header.sourceSize[i], header.sourceMtime[i]);
+
+    CountVisitor counter;
+    visitColumns(self, counter);
+    header.numColumns = counter.numColumns;
+
+    LayoutVisitor layout;
+    layout.offset = (sizeof(FileHeader) + header.numColumns * sizeof(ColumnEntry) + 7) & ~uint64_t(7);
+    visitColumns(self, layout);
+
+    // write next to the target and rename, so parallel runs never see a partial file
+    std::string tmpName = fileName + ".tmp" + std::to_string((long)getpid());
+    {
+        std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error("Cannot write compiled scenario file " + tmpName);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(layout.entries.data()), layout.entries.size() * sizeof(ColumnEntry));
+        static const char padding[8] = {0};
+        size_t headerBytes = sizeof(FileHeader) + layout.entries.size() * sizeof(ColumnEntry);
+        out.write(padding, ((headerBytes + 7) & ~size_t(7)) - headerBytes);
+
+        WriteVisitor writer = {out};
+        visitColumns(self, writer);
+        if (!out.good())
+            throw std::runtime_error("Error writing compiled scenario file " + tmpName);
+    }
+#ifdef _WIN32
+    remove(fileName.c_str());
+#endif
+    if (rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        remove(tmpName.c_str());
+        throw std::runtime_error("Cannot rename compiled scenario file to " + fileName);
+    }
+}
+
+bool ScenarioFile::map(const std::string& fileName)
+{
+    this->unmap();
+
+#ifdef _WIN32
+    // no mmap, read the whole file in one go instead
+    std::ifstream in(fileName, std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+        return false;
+    mappingSize = in.tellg();
+    mapping = operator new(mappingSize);
+    in.seekg(0);
+    in.read(static_cast<char *>(mapping), mappingSize);
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(FileHeader))
+    {
+        close(fd);
+        return false;
+    }
+    mappingSize = st.st_size;
+    mapping = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = NULL;
+        mappingSize = 0;
+        return false;
+    }
+#endif
+
+    const char *base = static_cast<const char *>(mapping);
+    FileHeader header;
+    bool ok = mappingSize >= sizeof(FileHeader);
+    if (ok)
+    {
+        memcpy(&header, base, sizeof(header));
+        ok = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION;
+    }
+
+    // a sheet that changed since compilation makes the file stale
+    for (int i = 0; ok && i < NUM_SOURCES; i++)
+    {
+        int64_t size, mtime;
+        statSource(sources[i], size, mtime);
+        ok = size == header.sourceSize[i] && mtime == header.sourceMtime[i];
+    }
+
+    CountVisitor counter;
+    visitColumns(*this, counter);
+    ok = ok && header.numColumns == counter.numColumns && mappingSize >= sizeof(FileHeader) + header.numColumns * sizeof(ColumnEntry);
+
+    if (ok)
+    {
+        MapVisitor mapper;
+        mapper.base = base;
+        mapper.size = mappingSize;
+        mapper.entries = reinterpret_cast<const ColumnEntry *>(base + sizeof(FileHeader));
+        visitColumns(*this, mapper);
+        ok = mapper.ok;
+    }
+
+    if (!ok)
+        this->unmap();
+    return ok;
+}
+
+void ScenarioFile::unmap()
+{
+    if (mapping)
+    {
+#ifdef _WIN32
+        operator delete(mapping);
+#else
+        munmap(mapping, mappingSize);
+#endif
+        mapping = NULL;
+        mappingSize = 0;
+    }
+    // fall back to the (possibly empty) owned storage
+    this->ownAll();
+}
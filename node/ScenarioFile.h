@@ -0,0 +1,109 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __SCENARIOFILE_H
+#define __SCENARIOFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * One column of a scenario table. The values either live in the column's own
+ * storage (parsed from the CSV sheets) or in a memory-mapped compiled file.
+ */
+template <typename T>
+struct ScenarioColumn
+{
+    const T *values = nullptr;
+    size_t count = 0;
+    std::vector<T> storage;
+
+    void push_back(const T& value) {storage.push_back(value);}
+    void own() {values = storage.data(); count = storage.size();}
+    size_t size() const {return count;}
+    const T& operator[](size_t i) const {return values[i];}
+};
+
+/**
+ * The scenario sheets of one scenario as columns:
+ *  - sheets/scenerioN_connections.csv
+ *  - sheets/scenerioN_sat_times.csv
+ *  - sheets/scenerioN_traffic_gen.csv
+ *
+ * The columns can be parsed from the CSV sheets, written to a versioned
+ * binary file (the "compiled" scenario), and mapped back from it with mmap,
+ * so later runs skip the text parsing and parallel runs on the same host
+ * share one page-cache copy of the data.
+ *
+ * File layout (native byte order): a header with the magic, the format
+ * version, the size and modification time of every source sheet, and a
+ * directory of {column id, element size, count, offset}; the column data
+ * follows, every column aligned to 8 bytes.
+ */
+class ScenarioFile
+{
+  public:
+    static const uint32_t VERSION = 2;
+
+    enum Source { CONNECTIONS, SAT_TIMES, TRAFFIC, NUM_SOURCES };
+
+    // connections: the ISL between to and from is up in [start, stop)
+    ScenarioColumn<double> connStart;
+    ScenarioColumn<double> connStop;
+    ScenarioColumn<int32_t> connTo;
+    ScenarioColumn<int32_t> connFrom;
+    ScenarioColumn<int32_t> connAscending;
+
+    // satellite times: status is 1 for START and 0 for STOP
+    ScenarioColumn<int32_t> timeIsStart;
+    ScenarioColumn<int32_t> timeSat;
+    ScenarioColumn<int32_t> timeSec;
+
+    // traffic generation, every row in file order
+    ScenarioColumn<int32_t> trafficSat;
+    ScenarioColumn<int32_t> trafficTime;
+    ScenarioColumn<int32_t> trafficNorth;
+    ScenarioColumn<int32_t> trafficAmount;
+
+  private:
+    std::string sources[NUM_SOURCES];
+    void *mapping;
+    size_t mappingSize;
+
+  public:
+    ScenarioFile();
+    ~ScenarioFile();
+
+    // the CSV sheets the columns come from; an empty name means "not used"
+    void setSources(const std::string& connections, const std::string& satTimes, const std::string& traffic);
+
+    // parse the CSV sheets
+    void readSheets();
+
+    // map a compiled file; false if it is missing, of another version or older than the sheets
+    bool map(const std::string& fileName);
+
+    // write the columns as a compiled file, atomically replacing an older one
+    void write(const std::string& fileName) const;
+
+  protected:
+    void unmap();
+    void ownAll();
+    void readConnections(const std::string& fileName);
+    void readSatelliteTimes(const std::string& fileName);
+    void readTraffic(const std::string& fileName);
+
+  private:
+    ScenarioFile(const ScenarioFile&);
+    ScenarioFile& operator=(const ScenarioFile&);
+};
+
+#endif
@@ -0,0 +1,336 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "OrbitPropagator.h"
+#include "ScenarioStore.h"
+using namespace omnetpp;
+
+Define_Module(ScenarioStore);
+
+
+ScenarioStore::ScenarioStore()
+{
+    // Apps may ask for their views before this module is initialized,
+    // so the sheets are loaded lazily on the first request
+    loaded = false;
+    scenerio_num = 0;
+}
+
+void ScenarioStore::initialize()
+{
+    this->ensureLoaded();
+}
+
+void ScenarioStore::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("ScenarioStore does not process messages");
+}
+
+const std::vector<ConnectionEvent>& ScenarioStore::getConnections(int address)
+{
+    Enter_Method_Silent();
+    this->ensureLoaded();
+    auto it = connectionsBySat.find(address);
+    return it != connectionsBySat.end() ? it->second : noConnections;
+}
+
+const std::vector<TrafficRecord>& ScenarioStore::getTraffic(int address)
+{
+    Enter_Method_Silent();
+    this->ensureLoaded();
+    auto it = trafficBySat.find(address);
+    return it != trafficBySat.end() ? it->second : noTraffic;
+}
+
+const SatelliteTimes& ScenarioStore::getSatelliteTimes()
+{
+    Enter_Method_Silent();
+    this->ensureLoaded();
+    return satelliteTimes;
+}
+
+bool ScenarioStore::isNorth(int address, double time)
+{
+    Enter_Method_Silent();
+    this->ensureLoaded();
+    auto it = directionBySat.find(address);
+    if (it == directionBySat.end())
+        return false;
+
+    // the most recent change that isn't later than the given time
+    const std::vector<DirectionChange>& changes = it->second;
+    auto next = std::upper_bound(changes.begin(), changes.end(), time,
+            [](double t, const DirectionChange& change) { return t < change.first; });
+    if (next == changes.begin())
+        return false;
+    return (next - 1)->second;
+}
+
+bool ScenarioStore::hasLiveConnection(int address, double time)
+{
+    Enter_Method_Silent();
+    this->ensureLoaded();
+    return linkIndex.isLive(address, time);
+}
+
+void ScenarioStore::ensureLoaded()
+{
+    if (loaded)
+        return;
+    loaded = true;
+
+    scenerio_num = getParentModule()->par("scenerio_num");
+    // the connections sheet is not needed if the windows come from the orbits
+    std::string connectionsSheet = par("propagateOrbits").boolValue() ? "" : this->getSheetName("_connections.csv");
+    sheets.setSources(connectionsSheet, this->getSheetName("_sat_times.csv"),
+            this->getSheetName("_traffic_gen.csv"));
+
+    // prefer the compiled scenario, unless it is missing or older than the sheets
+    std::string compiledName = this->getSheetName(".scn");
+    if (par("useCompiledScenario").boolValue() && sheets.map(compiledName))
+    {
+        EV << "using compiled scenario " << compiledName << endl;
+    }
+    else
+    {
+        sheets.readSheets();
+        if (par("writeCompiledScenario").boolValue())
+        {
+            try
+            {
+                sheets.write(compiledName);
+                EV << "compiled scenario written to " << compiledName << endl;
+            }
+            catch (std::exception& e)
+            {
+                EV_WARN << e.what() << endl;
+            }
+        }
+    }
+
+    this->loadConnections();
+    this->loadSatelliteTimes();
+    this->loadTraffic();
+}
+
+std::string ScenarioStore::getSheetName(const char *suffix) const
+{
+    return "sheets/scenerio" + std::to_string(scenerio_num) + suffix;
+}
+
+void ScenarioStore::loadConnections()
+{
+    std::vector<LinkWindow> windows;
+
+    if (par("propagateOrbits").boolValue())
+    {
+        this->propagateConnections(windows);
+    }
+    else
+    {
+        for (size_t i = 0; i < sheets.connStart.size(); i++)
+        {
+            LinkWindow window;
+            window.start = sheets.connStart[i];
+            window.stop = sheets.connStop[i];
+            window.to = sheets.connTo[i];
+            window.from = sheets.connFrom[i];
+            window.isAscending = sheets.connAscending[i];
+            windows.push_back(window);
+        }
+    }
+
+    // every connection is an event for both of its ends
+    for (const auto& window : windows)
+    {
+        connectionsBySat[window.to].push_back(std::make_tuple(window.start, window.stop, window.from, window.isAscending));
+        connectionsBySat[window.from].push_back(std::make_tuple(window.start, window.stop, window.to, window.isAscending));
+    }
+
+    // sort the connections of each satellite by start time
+    for (auto& item : connectionsBySat)
+    {
+        std::sort(item.second.begin(), item.second.end());
+    }
+
+    linkIndex.build(windows);
+}
+
+void ScenarioStore::propagateConnections(std::vector<LinkWindow>& windows)
+{
+    cModule *network = getParentModule();
+    OrbitPropagator orbits(ConstellationConfig::fromNetwork(network));
+
+    // the satellites are the nodes of the network
+    const char *nodeType = par("nodeType");
+    std::unordered_map<cModule *, int> satOfModule;
+    std::vector<cModule *> modules;
+    std::vector<int> addresses;
+    for (cModule::SubmoduleIterator it(network); !it.end(); ++it)
+    {
+        cModule *module = *it;
+        if (strcmp(module->getNedTypeName(), nodeType) != 0)
+            continue;
+        int address = module->par("address");
+        satOfModule[module] = orbits.addSatellite(address);
+        modules.push_back(module);
+        addresses.push_back(address);
+    }
+
+    // the candidate ISLs are the links between the planes, every pair once, "to" is the
+    // smaller address; the links within a plane never change and stay up all the time
+    std::vector<std::pair<int, int>> links;
+    for (cModule *module : modules)
+    {
+        int sat = satOfModule[module];
+        for (int g = 0; g < module->gateSize("port$o"); g++)
+        {
+            cGate *gate = module->gate("port$o", g)->getNextGate();
+            auto it = satOfModule.end();
+            while (gate != NULL && (it = satOfModule.find(gate->getOwnerModule())) == satOfModule.end())
+            {
+                gate = gate->getNextGate();
+            }
+            if (gate != NULL && addresses[sat] < addresses[it->second] && !orbits.inSamePlane(sat, it->second))
+                links.push_back(std::make_pair(sat, it->second));
+        }
+    }
+
+    double duration = par("propagationDuration");
+    double step = par("propagationStep");
+    if (step <= 0)
+        throw cRuntimeError("propagationStep must be positive");
+    double maxRange = par("maxIslRange").doubleValue();
+    double maxSinLatitude = sin(par("maxIslLatitude").doubleValue() * M_PI / 180);
+    double minGrazingAltitude = par("minGrazingAltitude").doubleValue();
+    double maxGrazingAltitude = orbits.getRadius() - OrbitPropagator::EARTH_RADIUS; // of a link of length 0
+    if (minGrazingAltitude >= maxGrazingAltitude)
+        throw cRuntimeError("minGrazingAltitude must be below the orbit altitude");
+
+    // margin of a link at the current step, up while it is >= 0: the smallest of the
+    // range, the line of sight and the latitude margins, all scaled to 1 at the center
+    auto margin = [&](const std::pair<int, int>& link) {
+        double range = orbits.getDistance(link.first, link.second) / maxRange;
+        double result = 1 - range * range;
+        double grazingAltitude = orbits.getGrazingAltitude(link.first, link.second);
+        result = std::min(result, (grazingAltitude - minGrazingAltitude) / (maxGrazingAltitude - minGrazingAltitude));
+        for (int sat : {link.first, link.second})
+        {
+            double latitude = orbits.getSinLatitude(sat) / maxSinLatitude;
+            result = std::min(result, 1 - latitude * latitude);
+        }
+        return result;
+    };
+
+    std::vector<double> lastMargin(links.size());
+    std::vector<int> open(links.size(), -1); // index of the open window of the link in windows, -1 if it is down
+    int numSteps = (int)ceil(duration / step);
+    for (int k = 0; k <= numSteps; k++)
+    {
+        double time = std::min(k * step, duration);
+        double lastTime = std::min((k - 1) * step, duration);
+        orbits.propagate(time);
+        for (size_t l = 0; l < links.size(); l++)
+        {
+            double m = margin(links[l]);
+            bool up = m >= 0;
+            if (up != (open[l] != -1))
+            {
+                // up or down somewhere since the last step, where the margin crosses 0
+                double crossing = k == 0 ? 0 : lastTime + (time - lastTime) * lastMargin[l] / (lastMargin[l] - m);
+                if (up)
+                {
+                    LinkWindow window;
+                    window.start = crossing;
+                    window.stop = std::numeric_limits<double>::infinity(); // unless it closes before the horizon
+                    window.to = addresses[links[l].first];
+                    window.from = addresses[links[l].second];
+                    window.isAscending = orbits.isAscending(links[l].first);
+                    open[l] = windows.size();
+                    windows.push_back(window);
+                }
+                else
+                {
+                    windows[open[l]].stop = crossing;
+                    open[l] = -1;
+                }
+            }
+            lastMargin[l] = m;
+        }
+    }
+    EV << "ISL windows: " << windows.size() << " on " << links.size() << " links of "
+       << orbits.size() << " satellites, propagated to " << duration << "s" << endl;
+}
+
+void ScenarioStore::loadSatelliteTimes()
+{
+    for (size_t i = 0; i < sheets.timeSat.size(); i++)
+    {
+        if (sheets.timeIsStart[i]) {
+            satelliteTimes[sheets.timeSat[i]].first = sheets.timeSec[i];
+        } else {
+            satelliteTimes[sheets.timeSat[i]].second = sheets.timeSec[i];
+        }
+    }
+}
+
+void ScenarioStore::loadTraffic()
+{
+    std::unordered_map<int, std::vector<DirectionChange>> directionRows;
+
+    for (size_t i = 0; i < sheets.trafficSat.size(); i++)
+    {
+        int address = sheets.trafficSat[i];
+
+        // every row counts for the direction of the satellite
+        directionRows[address].push_back(std::make_pair((int)sheets.trafficTime[i], sheets.trafficNorth[i] != 0));
+
+        // only rows that generate data are kept, in file order
+        if (sheets.trafficAmount[i] > 0)
+        {
+            TrafficRecord record;
+            record.time = sheets.trafficTime[i];
+            record.isValNorth = sheets.trafficNorth[i];
+            record.amount = sheets.trafficAmount[i];
+            trafficBySat[address].push_back(record);
+        }
+    }
+
+    this->buildDirectionIndex(directionRows);
+}
+
+void ScenarioStore::buildDirectionIndex(std::unordered_map<int, std::vector<DirectionChange>>& rows)
+{
+    // keep a sorted timeline of the is_val_north transitions of every satellite,
+    // so the state at a given time is a binary search instead of a rescan of the sheet
+    for (auto& item : rows)
+    {
+        std::vector<DirectionChange>& satRows = item.second;
+        std::stable_sort(satRows.begin(), satRows.end(),
+                [](const DirectionChange& a, const DirectionChange& b) { return a.first < b.first; });
+
+        std::vector<DirectionChange>& changes = directionBySat[item.first];
+        for (const auto& row : satRows)
+        {
+            // of several rows with the same time the last one wins
+            if (!changes.empty() && changes.back().first == row.first)
+            {
+                changes.pop_back();
+            }
+            if (changes.empty() || changes.back().second != row.second)
+            {
+                changes.push_back(row);
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __SCENARIOSTORE_H
+#define __SCENARIOSTORE_H
+
+#include <string>
+#include <tuple>
+#include <vector>
+#include <unordered_map>
+#include <omnetpp.h>
+#include "LinkIndex.h"
+#include "ScenarioFile.h"
+
+// one row of scenerioN_connections.csv, seen from a single satellite: {start, stop, neighbor, isAscending}
+typedef std::tuple<double, double, int, int> ConnectionEvent;
+
+// one row of scenerioN_traffic_gen.csv with data to send: {time, is_val_north, traffic}
+struct TrafficRecord
+{
+    int time;
+    int isValNorth;
+    int amount;
+};
+
+// a change of is_val_north of a satellite: {time, is_val_north}
+typedef std::pair<int, bool> DirectionChange;
+
+// satellite address -> {START time, STOP time} from scenerioN_sat_times.csv
+typedef std::unordered_map<int, std::pair<int, int>> SatelliteTimes;
+
+/**
+ * Loads the scenario sheets (connections, satellite times, traffic generation)
+ * once per run and hands out read-only per-satellite views to the App modules,
+ * instead of every App opening and parsing the same CSV files on its own.
+ *
+ * The sheets are compiled into a binary column file (sheets/scenerioN.scn)
+ * that later runs map into memory instead of parsing the text again.
+ *
+ * Instead of the connections sheet, the ISL windows can be derived from
+ * the orbits (propagateOrbits): all the satellites are propagated with
+ * OrbitPropagator at propagationStep, and a link of the network between
+ * two planes is up while its ends are within maxIslRange, its line of
+ * sight passes at least minGrazingAltitude above the Earth, and both of
+ * its ends are below maxIslLatitude. The up/down crossings are
+ * interpolated linearly between the steps; windows still open at propagationDuration never
+ * close (their stop is infinity). The links within a plane get no windows,
+ * they are always up. The windows take the place of the sheet's rows, so
+ * the Apps get the same connect/disconnect events.
+ */
+class ScenarioStore : public omnetpp::cSimpleModule
+{
+  private:
+    bool loaded;
+    int scenerio_num;
+    ScenarioFile sheets;
+
+    std::unordered_map<int, std::vector<ConnectionEvent>> connectionsBySat;
+    LinkIndex linkIndex; // coverage of the connection windows, for hasLiveConnection()
+    std::unordered_map<int, std::vector<TrafficRecord>> trafficBySat;
+    std::unordered_map<int, std::vector<DirectionChange>> directionBySat; // sorted by time, only the changes
+    SatelliteTimes satelliteTimes;
+
+    // returned for satellites that do not appear in a sheet
+    const std::vector<ConnectionEvent> noConnections;
+    const std::vector<TrafficRecord> noTraffic;
+
+  public:
+    ScenarioStore();
+
+    // read-only views, the sheets are parsed on the first call
+    const std::vector<ConnectionEvent>& getConnections(int address);
+    const std::vector<TrafficRecord>& getTraffic(int address);
+    const SatelliteTimes& getSatelliteTimes();
+
+    // is_val_north of the satellite at the given time, false if it has no traffic rows until then
+    bool isNorth(int address, double time);
+
+    // true if the satellite has a connection window with start <= time < stop
+    bool hasLiveConnection(int address, double time);
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+
+    virtual void ensureLoaded();
+    virtual std::string getSheetName(const char *suffix) const;
+    virtual void loadConnections();
+    virtual void propagateConnections(std::vector<LinkWindow>& windows);
+    virtual void loadSatelliteTimes();
+    virtual void loadTraffic();
+    virtual void buildDirectionIndex(std::unordered_map<int, std::vector<DirectionChange>>& rows);
+};
+
+#endif
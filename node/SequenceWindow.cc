@@ -0,0 +1,66 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include "SequenceWindow.h"
+
+SequenceWindow::SequenceWindow(long size)
+{
+    this->size = size < 64 ? 64 : (size + 63) / 64 * 64;
+    bits.assign(this->size / 64, 0);
+    base = 0;
+}
+
+bool SequenceWindow::insert(long seq)
+{
+    if (seq < base)
+        return missed.erase(seq);
+    if (seq >= base + size)
+    {
+        // make room, the unseen fragments pushed out are kept in missed
+        slideTo(seq - size + 1);
+    }
+    if (test(seq))
+        return false;
+    set(seq);
+
+    // move past the fragments that are complete
+    long newBase = base;
+    while (newBase < base + size && test(newBase))
+    {
+        newBase++;
+    }
+    slideTo(newBase);
+    return true;
+}
+
+bool SequenceWindow::contains(long seq) const
+{
+    if (seq < base)
+        return !missed.contains(seq);
+    if (seq >= base + size)
+        return false;
+    return test(seq);
+}
+
+void SequenceWindow::slideTo(long newBase)
+{
+    long end = newBase - base >= size ? base + size : newBase;
+    for (long seq = base; seq < end; seq++)
+    {
+        if (!test(seq))
+        {
+            // a full set is given up on, its fragments count as seen from now on
+            if ((long)missed.size() >= size)
+                missed.clear();
+            missed.insert(seq);
+        }
+        reset(seq);
+    }
+    base = newBase;
+}
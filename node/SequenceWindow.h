@@ -0,0 +1,53 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __SEQUENCEWINDOW_H
+#define __SEQUENCEWINDOW_H
+
+#include <cstdint>
+#include <vector>
+#include "TrafficKeySet.h"
+
+/**
+ * The fragments of one source an App has already seen, for duplicate
+ * suppression, as a sliding window over the source's sequence numbers.
+ *
+ * The window is a bitmap of a fixed number of sequence numbers starting at
+ * base. The base moves past every fragment that has been seen together with
+ * all the fragments before it, and is pushed forward when a fragment beyond
+ * the window arrives. The fragments the push leaves behind unseen are kept
+ * in a TrafficKeySet, so a late copy of one still counts as new; every other
+ * sequence number below the base counts as seen. Memory is therefore bounded
+ * by the window size, not by the length of the run.
+ */
+class SequenceWindow
+{
+  private:
+    std::vector<uint64_t> bits; // ring buffer, the bit of seq is seq % size
+    long base;  // lowest sequence number that may still be unseen
+    long size;  // number of sequence numbers in the window, a multiple of 64
+    TrafficKeySet missed;  // unseen sequence numbers below base, at most size of them
+
+  public:
+    SequenceWindow(long size = 4096);
+
+    // true if seq was not seen yet, and marks it seen
+    bool insert(long seq);
+    bool contains(long seq) const;
+
+    long getBase() const {return base;}
+
+  protected:
+    bool test(long seq) const {return bits[(seq % size) / 64] >> (seq % 64) & 1;}
+    void set(long seq) {bits[(seq % size) / 64] |= (uint64_t)1 << (seq % 64);}
+    void reset(long seq) {bits[(seq % size) / 64] &= ~((uint64_t)1 << (seq % 64));}
+    void slideTo(long newBase);
+};
+
+#endif
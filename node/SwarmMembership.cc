@@ -0,0 +1,290 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <algorithm>
+#include "SwarmMembership.h"
+using namespace omnetpp;
+
+Define_Module(SwarmMembership);
+
+
+SwarmMembership::SwarmMembership()
+{
+    // Apps may query before this module is initialized
+    scenario = NULL;
+    initialized = false;
+    nextChange = 0;
+    epoch = 0;
+    geometryEpoch = -1;
+}
+
+void SwarmMembership::initialize()
+{
+    this->ensureInitialized();
+    WATCH(epoch);
+}
+
+void SwarmMembership::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("SwarmMembership does not process messages");
+}
+
+void SwarmMembership::ensureInitialized()
+{
+    if (initialized)
+        return;
+    initialized = true;
+
+    config = ConstellationConfig::fromNetwork(getParentModule());
+    scenario = check_and_cast<ScenarioStore *>(getParentModule()->getSubmodule("scenario"));
+
+    // a satellite is active in [START, STOP)
+    for (const auto& item : scenario->getSatelliteTimes())
+    {
+        if (item.second.second <= item.second.first)
+            continue; // never active
+        MembershipChange start = {(double)item.second.first, item.first, true};
+        MembershipChange stop = {(double)item.second.second, item.first, false};
+        changes.push_back(start);
+        changes.push_back(stop);
+    }
+    std::stable_sort(changes.begin(), changes.end(),
+            [](const MembershipChange& a, const MembershipChange& b) { return a.time < b.time; });
+}
+
+void SwarmMembership::advance(double time)
+{
+    // apply all the changes that are due by the given time
+    while (nextChange < changes.size() && changes[nextChange].time <= time)
+    {
+        const MembershipChange& change = changes[nextChange++];
+        if (change.joins)
+            this->join(change.address);
+        else
+            this->leave(change.address);
+    }
+}
+
+void SwarmMembership::join(int address)
+{
+    if (!active.insert(address).second)
+        return;
+    planeCount[config.planeOf(address)]++;
+    orensCount[this->convertToOrensIndex(address)]++;
+    epoch++;
+}
+
+void SwarmMembership::leave(int address)
+{
+    if (active.erase(address) == 0)
+        return;
+    int plane = config.planeOf(address);
+    if (--planeCount[plane] == 0)
+        planeCount.erase(plane);
+    int orens = this->convertToOrensIndex(address);
+    if (--orensCount[orens] == 0)
+        orensCount.erase(orens);
+    epoch++;
+}
+
+const std::set<int>& SwarmMembership::getActiveSet()
+{
+    Enter_Method_Silent();
+    this->ensureInitialized();
+    this->advance(simTime().dbl());
+    return active;
+}
+
+long SwarmMembership::getEpoch()
+{
+    Enter_Method_Silent();
+    this->ensureInitialized();
+    this->advance(simTime().dbl());
+    return epoch;
+}
+
+std::vector<int> SwarmMembership::getASorMAS(bool giveAS)
+{
+    // get AS or MAS depending on giveAS
+    std::vector<int> set;
+    for (auto & sat : this->getActiveSet()) {
+        if (scenario->isNorth(sat, simTime().dbl()) == giveAS)
+        {
+            set.push_back(sat);
+        }
+    }
+    return set;
+}
+
+std::vector<int> SwarmMembership::getAPS()
+{
+    // the planes of AS and MAS together, i.e. of all the active satellites
+    this->getActiveSet();
+    std::vector<int> APS;
+    for (const auto& item : planeCount) {
+        APS.push_back(item.first);
+    }
+    return APS;
+}
+
+const SwarmGeometry& SwarmMembership::getGeometry()
+{
+    Enter_Method_Silent();
+    this->getActiveSet();
+    if (geometryEpoch == epoch)
+    {
+        return geometry;
+    }
+
+    if (active.empty())
+    {
+        // no swarm, no geometry
+        geometry.b1 = geometry.b2 = geometry.v = geometry.u = geometry.j = -1;
+    }
+    else
+    {
+        std::vector<int> b1b2 = this->calculateb1b2();
+        std::vector<int> vu = this->calculateVU();
+        geometry.b1 = b1b2[0];
+        geometry.b2 = b1b2[1];
+        geometry.v = vu[0];
+        geometry.u = vu[1];
+        geometry.j = !config.goLeft ? this->calculateJ(geometry.u) : this->calculateJ(geometry.v);
+    }
+    geometryEpoch = epoch;
+    return geometry;
+}
+
+std::vector<int> SwarmMembership::calculateb1b2()
+{
+    // calclualte b1 and b2 from the algo
+    std::vector<int> APS = this->getAPS();
+    EV_DEBUG << "APS: ";
+    for (auto & aps : APS) {
+        EV_DEBUG << aps << " ";
+    }
+    EV_DEBUG << endl;
+
+    int max_dist = -1;
+    int b1 = -1;
+    int b2 = -1;
+    // find the farthest planes
+    for (size_t i=0;i+1<APS.size();i++)
+    {
+        int currentGap= APS[i+1] - APS[i];
+        if(currentGap>max_dist)
+        {
+            max_dist=currentGap;
+            b1=APS[i];
+            b2=APS[i+1];
+        }
+    }
+    // Check if there is a gap between the last and first numbers in the cycle
+    int gapBetweenEndAndStart = APS.front() + (config.numPlanes - APS.back());
+    if (gapBetweenEndAndStart > max_dist) {
+        max_dist = gapBetweenEndAndStart;
+        b1 = APS.back();
+        b2 = APS.front();
+    }
+
+    // return findings
+    std::vector<int> edges;
+    edges.push_back(b1);edges.push_back(b2);
+    EV_DEBUG << "b1: " << b1 << ", b2; " << b2 << endl;
+    return edges;
+}
+
+std::vector<int> SwarmMembership::calculateVU()
+{
+    // return VU (west and eastmost) indexes for algorithm in oren's notation
+    std::vector<int> orens;
+    for (const auto& item : orensCount) {
+        orens.push_back(item.first);
+    }
+
+    int max_dist = -1; // initialize to minimum possible distance
+    int c1 = -1;
+    int c2 = -1;
+
+    // Iterate through the sorted numbers and find the biggest gap
+    for (size_t i = 0; i + 1 < orens.size(); i++) {
+        int currentGap = orens[i + 1] - orens[i];
+        if (currentGap > max_dist) {
+            max_dist = currentGap;
+            c1 = orens[i];
+            c2 = orens[i + 1];
+        }
+    }
+
+    // Check if there is a gap between the last and first numbers in the cycle
+    int gapBetweenEndAndStart = orens.front() + (config.numSatPerPlane - orens.back());
+    if (gapBetweenEndAndStart > max_dist) {
+        max_dist = gapBetweenEndAndStart;
+        c1 = orens.back();
+        c2 = orens.front();
+    }
+
+    // we have the edges, now which one is or west
+    // c1 and c2 can be either east,west or west,east
+    // lets assume c1<c2
+    if (c1>c2)
+    {
+        std::swap(c1, c2);
+    }
+
+    // check if each address is between c1 and c2, i.e ...c1...address...c2..
+    bool in_between = false;
+    for (auto & oren : orens)
+    {
+        if (c1 < oren && oren < c2)
+        {
+            in_between = true;
+            break;
+        }
+    }
+
+    std::vector<int> vu;
+    if (in_between)
+    {
+        // then c1 is west and c2 is east
+        vu.push_back(c1);
+        vu.push_back(c2);
+    }
+    else
+    {
+        // then c1 is east and c2 is west
+        vu.push_back(c2);
+        vu.push_back(c1);
+    }
+    EV_DEBUG << "v: " << vu[0] << ", u; " << vu[1] << endl;
+    return vu;
+}
+
+int SwarmMembership::calculateJ(int vu)
+{
+    // given u or v in orens notation, finds the corresponding j in orens notation
+    int jindex;
+    if(!config.goLeft)
+    {
+        jindex = ((vu / 2 + 1) * 2) % config.numSatPerPlane;
+    }
+    else
+    {
+        jindex = (vu - 1) % config.numSatPerPlane;
+    }
+    EV_DEBUG << "j: "  << jindex << endl;
+    return jindex;
+}
+
+int SwarmMembership::convertToOrensIndex(int address)
+{
+    // given an address calculate the respondings orens index
+    this->ensureInitialized();
+    return config.orensIndexOf(address);
+}
@@ -0,0 +1,95 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __SWARMMEMBERSHIP_H
+#define __SWARMMEMBERSHIP_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <omnetpp.h>
+#include "ScenarioStore.h"
+#include "ConstellationConfig.h"
+
+// swarm geometry carried by every new packet
+struct SwarmGeometry
+{
+    int b1;
+    int b2;
+    int v;
+    int u;
+    int j;
+};
+
+/**
+ * Network-level view of the virtual swarm, shared by all the App modules.
+ *
+ * The active set is maintained incrementally from the START/STOP times of
+ * the scenario: every query first applies the membership changes that are
+ * due by the current simulation time, so the cost is proportional to the
+ * number of changes, not to the number of satellites. AS/MAS/APS and the
+ * LPVS geometry (b1/b2, v/u, j) are published through direct method calls;
+ * the geometry is recomputed once per membership epoch.
+ */
+class SwarmMembership : public omnetpp::cSimpleModule
+{
+  private:
+    // a START (joins) or STOP of a satellite
+    struct MembershipChange
+    {
+        double time;
+        int address;
+        bool joins;
+    };
+
+    ScenarioStore *scenario;
+    bool initialized;
+    ConstellationConfig config;
+
+    std::vector<MembershipChange> changes; // sorted by time
+    size_t nextChange;
+
+    // the active set, and how many active satellites are on every plane / orens index
+    std::set<int> active;
+    std::map<int, int> planeCount;
+    std::map<int, int> orensCount;
+
+    long epoch;          // bumped whenever the active set changes
+    long geometryEpoch;  // epoch the cached geometry belongs to
+    SwarmGeometry geometry;
+
+  public:
+    SwarmMembership();
+
+    // the active satellites at the current simulation time
+    const std::set<int>& getActiveSet();
+    std::vector<int> getASorMAS(bool giveAS);
+    std::vector<int> getAPS();
+    const SwarmGeometry& getGeometry();
+    long getEpoch();
+
+    // oren's index (position along the plane, including the inter-plane phase shift) of an address
+    int convertToOrensIndex(int address);
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+
+    virtual void ensureInitialized();
+    virtual void advance(double time);
+    virtual void join(int address);
+    virtual void leave(int address);
+
+    // calculate for algo
+    virtual std::vector<int> calculateb1b2();
+    virtual std::vector<int> calculateVU();
+    virtual int calculateJ(int vu);
+};
+
+#endif
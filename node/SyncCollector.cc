@@ -0,0 +1,111 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "SyncCollector.h"
+using namespace omnetpp;
+
+Define_Module(SyncCollector);
+
+
+SyncCollector::SyncCollector()
+{
+    membership = NULL;
+    numSynced = 0;
+    mean = 0;
+    m2 = 0;
+}
+
+void SyncCollector::initialize()
+{
+    membership = check_and_cast<SwarmMembership *>(getParentModule()->getSubmodule("membership"));
+    convergenceTolerance = par("convergenceTolerance");
+    minSamples = par("minSamples");
+
+    syncTimeSignal = registerSignal("syncTime");
+    accumulatedHopsSignal = registerSignal("accumulatedHops");
+    WATCH(numSynced);
+}
+
+void SyncCollector::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("SyncCollector does not process messages");
+}
+
+void SyncCollector::fragmentGenerated(int source, int seqNum)
+{
+    Enter_Method_Silent();
+
+    // the other members of the swarm at this time must receive it
+    const std::set<int>& active = membership->getActiveSet();
+    std::vector<int> members;
+    for (int address : active)
+    {
+        if (address != source)
+            members.push_back(address);
+    }
+    if (members.empty())
+        return;
+    Pending& fragment = pending[makeKey(source, seqNum)];
+    fragment.created = simTime();
+    fragment.awaiting.swap(members);
+    fragment.hops = 0;
+}
+
+void SyncCollector::fragmentReceived(int source, int seqNum, int receiver, int hops)
+{
+    Enter_Method_Silent();
+
+    auto it = pending.find(makeKey(source, seqNum));
+    if (it == pending.end())
+        return; // already synced, or generated while the swarm was empty
+    Pending& fragment = it->second;
+
+    // only the first reception of a member counts, joining satellites and outsiders don't
+    auto member = std::lower_bound(fragment.awaiting.begin(), fragment.awaiting.end(), receiver);
+    if (member == fragment.awaiting.end() || *member != receiver)
+        return;
+    fragment.awaiting.erase(member);
+    fragment.hops += hops;
+    if (fragment.awaiting.empty())
+    {
+        this->synced(fragment);
+        pending.erase(it);
+    }
+}
+
+void SyncCollector::synced(const Pending& fragment)
+{
+    simtime_t syncTime = simTime() - fragment.created;
+    emit(syncTimeSignal, syncTime);
+    emit(accumulatedHopsSignal, fragment.hops);
+
+    // running mean and variance of the sync time (Welford)
+    numSynced++;
+    double delta = syncTime.dbl() - mean;
+    mean += delta / numSynced;
+    m2 += delta * (syncTime.dbl() - mean);
+
+    if (convergenceTolerance > 0 && numSynced >= minSamples && numSynced > 1 && mean > 0)
+    {
+        double halfWidth = 1.96 * std::sqrt(m2 / (numSynced - 1) / numSynced);
+        if (halfWidth / mean < convergenceTolerance)
+        {
+            EV << "sync time converged to " << mean << "s after " << numSynced << " fragments" << endl;
+            endSimulation();
+        }
+    }
+}
+
+void SyncCollector::finish()
+{
+    recordScalar("#synced", numSynced);
+    recordScalar("#unsynced", pending.size());
+}
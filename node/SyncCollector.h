@@ -0,0 +1,76 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __SYNCCOLLECTOR_H
+#define __SYNCCOLLECTOR_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <omnetpp.h>
+#include "SwarmMembership.h"
+
+/**
+ * Computes the synchronization metrics of the swarm during the run.
+ *
+ * Every fragment generated by an active satellite must reach the other
+ * members of the swarm (the active set when it was generated, kept with
+ * the fragment). The Apps report every fragment they generate and every
+ * first reception of one; receptions by satellites that were not members
+ * then are not counted. When the last member receives it, the sync time
+ * (time since generation) and the accumulated hops (sum of the hop counts
+ * of the members' first receptions) are emitted as signals.
+ *
+ * Optionally the run is ended once the mean sync time has converged: when
+ * the 95% confidence half-width relative to the mean drops below
+ * convergenceTolerance, after at least minSamples fragments.
+ */
+class SyncCollector : public omnetpp::cSimpleModule
+{
+  private:
+    // a fragment that did not reach all the members yet
+    struct Pending
+    {
+        omnetpp::simtime_t created;
+        std::vector<int> awaiting; // addresses of the members that did not receive it yet, sorted
+        long hops;      // accumulated hops so far
+    };
+
+    SwarmMembership *membership;
+    std::unordered_map<uint64_t, Pending> pending; // {source, sequence number} -> progress
+    long numSynced;
+
+    // convergence of the mean sync time
+    double convergenceTolerance;
+    long minSamples;
+    double mean;
+    double m2;
+
+    omnetpp::simsignal_t syncTimeSignal;
+    omnetpp::simsignal_t accumulatedHopsSignal;
+
+  public:
+    SyncCollector();
+
+    // a new fragment was generated by source
+    void fragmentGenerated(int source, int seqNum);
+
+    // receiver got the fragment for the first time, after the given hops
+    void fragmentReceived(int source, int seqNum, int receiver, int hops);
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+
+    virtual void synced(const Pending& fragment);
+    static uint64_t makeKey(int source, int seqNum) {return (uint64_t)(uint32_t)source << 32 | (uint32_t)seqNum;}
+};
+
+#endif
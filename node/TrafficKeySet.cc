@@ -0,0 +1,107 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include "TrafficKeySet.h"
+
+const uint64_t TrafficKeySet::EMPTY;
+
+TrafficKeySet::TrafficKeySet()
+{
+    slots.assign(64, EMPTY);
+    count = 0;
+}
+
+size_t TrafficKeySet::hash(uint64_t key)
+{
+    // splitmix64 finalizer, the keys are far from uniform
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return (size_t)key;
+}
+
+bool TrafficKeySet::insert(uint64_t key)
+{
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(key) & mask; ; i = (i + 1) & mask)
+    {
+        if (slots[i] == key)
+            return false;
+        if (slots[i] == EMPTY)
+        {
+            slots[i] = key;
+            if (++count * 2 > slots.size())
+                grow();
+            return true;
+        }
+    }
+}
+
+bool TrafficKeySet::erase(uint64_t key)
+{
+    size_t mask = slots.size() - 1;
+    size_t i = hash(key) & mask;
+    while (slots[i] != key)
+    {
+        if (slots[i] == EMPTY)
+            return false;
+        i = (i + 1) & mask;
+    }
+
+    // backward shift: move up the keys of the run that probed past the hole
+    for (size_t j = (i + 1) & mask; slots[j] != EMPTY; j = (j + 1) & mask)
+    {
+        size_t home = hash(slots[j]) & mask;
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i] = EMPTY;
+    count--;
+    return true;
+}
+
+bool TrafficKeySet::contains(uint64_t key) const
+{
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(key) & mask; ; i = (i + 1) & mask)
+    {
+        if (slots[i] == key)
+            return true;
+        if (slots[i] == EMPTY)
+            return false;
+    }
+}
+
+void TrafficKeySet::clear()
+{
+    slots.assign(64, EMPTY);
+    count = 0;
+}
+
+void TrafficKeySet::grow()
+{
+    std::vector<uint64_t> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, EMPTY);
+    size_t mask = slots.size() - 1;
+    for (uint64_t key : old)
+    {
+        if (key == EMPTY)
+            continue;
+        size_t i = hash(key) & mask;
+        while (slots[i] != EMPTY)
+            i = (i + 1) & mask;
+        slots[i] = key;
+    }
+}
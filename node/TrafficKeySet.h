@@ -0,0 +1,50 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 1992-2008 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#ifndef __TRAFFICKEYSET_H
+#define __TRAFFICKEYSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set of 64-bit fragment keys, for duplicate suppression.
+ *
+ * The keys are kept in an open addressing table with linear probing, so a
+ * lookup touches one or two adjacent slots and never allocates; the table
+ * doubles when it gets half full. SequenceWindow keeps the fragments that
+ * left its window unseen in one.
+ */
+class TrafficKeySet
+{
+  private:
+    static const uint64_t EMPTY = ~(uint64_t)0;
+
+    std::vector<uint64_t> slots; // power of two sized, EMPTY marks a free slot
+    size_t count;
+
+  public:
+    TrafficKeySet();
+
+    // true if the key was not in the set yet
+    bool insert(uint64_t key);
+    // true if the key was in the set
+    bool erase(uint64_t key);
+    bool contains(uint64_t key) const;
+
+    size_t size() const {return count;}
+    void clear();
+
+  protected:
+    static size_t hash(uint64_t key);
+    void grow();
+};
+
+#endif
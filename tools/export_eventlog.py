@@ -0,0 +1,83 @@
+# Export the binary event log of a run (ResultWriter.eventLog) to CSV or Parquet.
+#
+#   python tools/export_eventlog.py outfiles/events.bin events.csv
+#   python tools/export_eventlog.py outfiles/events.bin events.parquet --format parquet
+#   python tools/export_eventlog.py outfiles/events.bin outfiles --split
+#
+# --split writes one recvN.csv per satellite in the layout the simulation
+# writes it, and one sentTimesN.csv with just the sending times. The event log
+# does not record the active satellites of the simulation's sentN.csv lines,
+# so that layout cannot be rebuilt from it.
+import argparse
+import os
+import sys
+
+import numpy as np
+import pandas as pd
+
+MAGIC = b'LPVSLOG\0'
+VERSION = 1
+HEADER_SIZE = 16
+
+EVENT_RECEIVED = 0
+EVENT_SENT = 1
+
+# must match EventRecord in node/ResultWriter.h
+RECORD = np.dtype([
+    ('time', '<f8'),
+    ('latency', '<f8'),
+    ('kind', '<i4'),
+    ('sender', '<i4'),
+    ('receiver', '<i4'),
+    ('fragment', '<i4'),
+    ('hops', '<i4'),
+    ('bits', '<i4'),
+])
+
+
+def read_eventlog(file_name):
+    # Read the records of an event log into a DataFrame
+    with open(file_name, 'rb') as f:
+        header = f.read(HEADER_SIZE)
+        if len(header) < HEADER_SIZE or header[:8] != MAGIC:
+            raise ValueError(f'{file_name} is not an event log')
+        version = int.from_bytes(header[8:12], 'little')
+        record_size = int.from_bytes(header[12:16], 'little')
+        if version != VERSION or record_size != RECORD.itemsize:
+            raise ValueError(f'{file_name}: unsupported version {version} or record size {record_size}')
+        records = np.fromfile(f, dtype=RECORD)
+    return pd.DataFrame(records)
+
+
+def write_split(df, out_dir):
+    # One recvN.csv and sentTimesN.csv per satellite, without a header like the simulation writes its files
+    os.makedirs(out_dir, exist_ok=True)
+    received = df[df['kind'] == EVENT_RECEIVED]
+    for receiver, rows in received.groupby('receiver'):
+        rows[['time', 'sender', 'latency', 'fragment', 'hops', 'bits']].to_csv(
+            os.path.join(out_dir, f'recv{receiver}.csv'), header=False, index=False)
+    sent = df[df['kind'] == EVENT_SENT]
+    for sender, rows in sent.groupby('sender'):
+        rows[['time']].to_csv(os.path.join(out_dir, f'sentTimes{sender}.csv'), header=False, index=False)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Export a binary event log to CSV or Parquet')
+    parser.add_argument('eventlog')
+    parser.add_argument('output', help='output file, or directory with --split')
+    parser.add_argument('--format', choices=['csv', 'parquet'], default='csv')
+    parser.add_argument('--split', action='store_true', help='per-satellite recvN.csv/sentTimesN.csv files')
+    args = parser.parse_args()
+
+    df = read_eventlog(args.eventlog)
+    if args.split:
+        write_split(df, args.output)
+    elif args.format == 'parquet':
+        df.to_parquet(args.output, index=False)  # needs pyarrow or fastparquet
+    else:
+        df.to_csv(args.output, index=False)
+    print(f'{len(df)} events exported', file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()